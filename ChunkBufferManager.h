@@ -4,12 +4,24 @@
 
 #include <vector>
 #include <mutex>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <glad/glad.h>
 #include <unordered_map>
+#include "ChunkRenderBackend.h" // ChunkQuadUpload
 
-// Manages a persistently-mapped SSBO ring buffer for quad data (uint64_t per quad).
+// Manages the SSBO that holds every chunk's quad data (uint64_t per quad).
+// It does no allocation of its own: ChunkHandler's UniversalPool hands out the
+// slot ranges, and a range is only handed out again once the GPU is done with it
+// (see ChunkHandler::endFrame), so writes never land on quads still being drawn.
+//
+// The quad heap itself is GPU-only. Quads are written into a persistently-mapped
+// staging ring of STAGING_REGIONS regions and copied into the heap on the GPU
+// (glCopyNamedBufferSubData). Each region is fenced when the frame that filled
+// it ends, and the CPU only writes a region again after its fence signaled,
+// which with three regions is normally long before it comes around.
 class ChunkBufferManager {
 public:
     struct ChunkMeshInfo {
@@ -17,41 +29,109 @@ public:
         uint32_t quadCount;     // Number of quads for this chunk
     };
 
-    // Initialize the SSBO ring buffer to hold maxQuads uint64_t entries
+    static constexpr int STAGING_REGIONS = 3;
+
+    // Initialize the quad heap to hold maxQuads uint64_t entries, plus the
+    // staging ring (stagingRegionBytes per region).
     // Must be called after GL context creation.
-    void initialize(size_t maxQuads) {
+    void initialize(size_t maxQuads, size_t stagingRegionBytes = 16u << 20) {
         totalSlots = maxQuads;
         bufferSize = maxQuads * sizeof(uint64_t);
         glCreateBuffers(1, &ssbo);
-        glNamedBufferStorage(ssbo,
-            bufferSize,
+        glNamedBufferStorage(ssbo, bufferSize, nullptr, 0); // only written by GPU copies
+
+        regionSize = stagingRegionBytes / sizeof(uint64_t) * sizeof(uint64_t);
+        const size_t stagingSize = regionSize * STAGING_REGIONS;
+        glCreateBuffers(1, &stagingBuffer);
+        glNamedBufferStorage(stagingBuffer,
+            stagingSize,
             nullptr,
-            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT);
-        mappedPtr = reinterpret_cast<uint64_t*>(
-            glMapNamedBufferRange(ssbo, 0, bufferSize,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        stagingPtr = reinterpret_cast<uint8_t*>(
+            glMapNamedBufferRange(stagingBuffer, 0, stagingSize,
                 GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
-        writeCursor = 0;
+        region = 0;
+        regionCursor = 0;
     }
 
-    // Stage quad data for a chunk: copy quads into the ring buffer at current cursor,
-    // record offset and count, then advance cursor (wrapping if necessary).
-    void stageChunkData(uint64_t chunkKey,
-                        const std::vector<uint64_t>& quads,
-                        uint32_t poolSlotOffset) {
+    // Stage a batch of chunks: when it fits in one region, all quads are written
+    // back to back with a single memcpy run and copied into the heap with one
+    // GPU copy per run of chunks that are also adjacent in the heap.
+    // Bigger batches fall back to per-chunk staging split across regions.
+    void stageChunkBatch(const ChunkQuadUpload* uploads, size_t count) {
         std::lock_guard<std::mutex> lock(mutex);
-        size_t byteCount = quads.size() * sizeof(uint64_t);
-        // Wrap if not enough space at end
-        if ((writeCursor + byteCount) > bufferSize) {
-            writeCursor = 0;
+        size_t totalBytes = 0;
+        for (size_t i = 0; i < count; ++i) totalBytes += size_t(uploads[i].quadCount) * sizeof(uint64_t);
+        if (totalBytes == 0) return;
+
+        if (totalBytes > regionSize) {
+            for (size_t i = 0; i < count; ++i) stageSplit(uploads[i]);
+            return;
+        }
+        if (regionSize - regionCursor < totalBytes) advanceRegion();
+
+        // One contiguous write into the region
+        const size_t base = region * regionSize + regionCursor;
+        size_t cursor = base;
+        for (size_t i = 0; i < count; ++i) {
+            const ChunkQuadUpload& u = uploads[i];
+            if (!inBounds(u)) continue; // pool and buffer out of sync: drop, never wrap
+            const size_t n = size_t(u.quadCount) * sizeof(uint64_t);
+            std::memcpy(stagingPtr + cursor, u.quads, n);
+            cursor += n;
+            meshInfos[u.chunkKey] = { u.slotOffset, u.quadCount };
         }
-        // Copy directly into GPU-mapped memory
-        std::memcpy(mappedPtr + (writeCursor / sizeof(uint64_t)),
-                    quads.data(), byteCount);
-        // Record info
-        meshInfos[chunkKey] = { static_cast<uint32_t>(writeCursor / sizeof(uint64_t)),
-                                 static_cast<uint32_t>(quads.size()) };
-        // Advance cursor
-        writeCursor += byteCount;
+
+        // Copies, merged while the destinations follow each other like the sources do
+        size_t runSrc = base, runDst = 0, runBytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const ChunkQuadUpload& u = uploads[i];
+            if (!inBounds(u) || u.quadCount == 0) continue;
+            const size_t dst = size_t(u.slotOffset) * sizeof(uint64_t);
+            const size_t n = size_t(u.quadCount) * sizeof(uint64_t);
+            if (runBytes && dst == runDst + runBytes) {
+                runBytes += n;
+                continue;
+            }
+            if (runBytes) glCopyNamedBufferSubData(stagingBuffer, ssbo, runSrc, runDst, runBytes);
+            runSrc += runBytes;
+            runDst = dst;
+            runBytes = n;
+        }
+        if (runBytes) glCopyNamedBufferSubData(stagingBuffer, ssbo, runSrc, runDst, runBytes);
+        regionCursor += cursor - base;
+    }
+
+    // Replace the heap with a bigger buffer; the resident quads are copied over on
+    // the GPU, after every copy already queued into the old one. GL keeps the old
+    // buffer alive until the frames in flight that read it have finished.
+    void grow(size_t maxQuads) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (maxQuads <= totalSlots) return;
+        GLuint grown = 0;
+        glCreateBuffers(1, &grown);
+        glNamedBufferStorage(grown, maxQuads * sizeof(uint64_t), nullptr, 0);
+        glCopyNamedBufferSubData(ssbo, grown, 0, 0, bufferSize);
+        glDeleteBuffers(1, &ssbo);
+
+        ssbo = grown;
+        totalSlots = maxQuads;
+        bufferSize = maxQuads * sizeof(uint64_t);
+    }
+
+    // GPU-side move of quads inside the heap (compaction); ranges must not overlap
+    void copyWithinHeap(uint32_t srcSlot, uint32_t dstSlot, uint32_t quadCount) {
+        if (size_t(srcSlot) + quadCount > totalSlots || size_t(dstSlot) + quadCount > totalSlots) return;
+        glCopyNamedBufferSubData(ssbo, ssbo,
+            size_t(srcSlot) * sizeof(uint64_t), size_t(dstSlot) * sizeof(uint64_t),
+            size_t(quadCount) * sizeof(uint64_t));
+    }
+
+    // Close the current staging region at the end of a frame, so the next
+    // frame's uploads never wait on copies that were just submitted.
+    void endFrame() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (regionCursor > 0) advanceRegion();
     }
 
     // Bind the SSBO to a specified binding point for your shader to read
@@ -69,11 +149,19 @@ public:
         meshInfos.clear();
     }
 
-    // Destroy the SSBO and unmap
+    // Destroy the buffers and unmap
     void destroy() {
-        if (mappedPtr) {
-            glUnmapNamedBuffer(ssbo);
-            mappedPtr = nullptr;
+        for (GLsync& fence : regionFences) {
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
+        if (stagingPtr) {
+            glUnmapNamedBuffer(stagingBuffer);
+            stagingPtr = nullptr;
+        }
+        if (stagingBuffer) {
+            glDeleteBuffers(1, &stagingBuffer);
+            stagingBuffer = 0;
         }
         if (ssbo) {
             glDeleteBuffers(1, &ssbo);
@@ -83,11 +171,60 @@ public:
     }
 
 private:
-    GLuint ssbo = 0;
-    uint64_t* mappedPtr = nullptr;
+    bool inBounds(const ChunkQuadUpload& u) const {
+        return size_t(u.slotOffset) + u.quadCount <= totalSlots;
+    }
+
+    // Stage one chunk, split across regions where the current one runs out
+    void stageSplit(const ChunkQuadUpload& u) {
+        if (!inBounds(u)) return; // pool and buffer out of sync: drop, never wrap
+
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(u.quads);
+        size_t remaining = size_t(u.quadCount) * sizeof(uint64_t);
+        size_t dst = size_t(u.slotOffset) * sizeof(uint64_t);
+        while (remaining > 0) {
+            if (regionCursor == regionSize) advanceRegion();
+            const size_t n = std::min(remaining, regionSize - regionCursor);
+            const size_t stagingOffset = region * regionSize + regionCursor;
+
+            std::memcpy(stagingPtr + stagingOffset, src, n);
+            glCopyNamedBufferSubData(stagingBuffer, ssbo, stagingOffset, dst, n);
+
+            regionCursor += n;
+            src += n; dst += n; remaining -= n;
+        }
+        meshInfos[u.chunkKey] = { u.slotOffset, u.quadCount };
+    }
+
+    // Fence the copies that read the current region, then wait until the next
+    // region's copies (issued STAGING_REGIONS - 1 closes ago) have finished.
+    void advanceRegion() {
+        regionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % STAGING_REGIONS;
+        regionCursor = 0;
+
+        GLsync& fence = regionFences[region];
+        if (!fence) return;
+        GLenum state = glClientWaitSync(fence, 0, 0);
+        while (state == GL_TIMEOUT_EXPIRED) {
+            // Only when more than the whole ring was staged within a few frames
+            state = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000); // 1 ms
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    GLuint ssbo = 0;               // quad heap
     size_t bufferSize = 0;
     size_t totalSlots = 0;
-    size_t writeCursor = 0;
+
+    GLuint stagingBuffer = 0;
+    uint8_t* stagingPtr = nullptr;
+    size_t regionSize = 0;         // bytes per staging region
+    int region = 0;                // region being written
+    size_t regionCursor = 0;       // bytes used in it
+    GLsync regionFences[STAGING_REGIONS] = {};
+
     std::mutex mutex;
     // Map from application chunk ID or hash key to mesh slot info
     std::unordered_map<uint64_t, ChunkMeshInfo> meshInfos;
@@ -0,0 +1,89 @@
+
+#include "ChunkDrawTable.h"
+#include <algorithm>
+
+// Dirty entries closer than this are uploaded as one range: rewriting a few
+// clean 32-byte entries is cheaper than another buffer update call.
+static constexpr uint32_t DIRTY_MERGE_GAP = 8;
+
+uint32_t ChunkDrawTable::add(const glm::ivec3& coords, uint32_t firstQuad, uint32_t quadCount) {
+    const uint32_t index = static_cast<uint32_t>(coords_.size());
+    coords_.emplace_back();
+    firsts_.emplace_back();
+    counts_.emplace_back();
+    flags_.emplace_back();
+    chunkData_.emplace_back();
+    write(index, coords, firstQuad, quadCount);
+    return index;
+}
+
+void ChunkDrawTable::update(uint32_t index, uint32_t firstQuad, uint32_t quadCount) {
+    write(index, coords_[index], firstQuad, quadCount);
+}
+
+uint32_t ChunkDrawTable::remove(uint32_t index) {
+    const uint32_t last = static_cast<uint32_t>(coords_.size() - 1);
+    if (index != last) {
+        coords_[index] = coords_[last];
+        firsts_[index] = firsts_[last];
+        counts_[index] = counts_[last];
+        flags_[index] = flags_[last] & ~DIRTY; // 'last' may sit in dirty_; it gets filtered out
+        chunkData_[index] = chunkData_[last];
+        markDirty(index);
+    }
+    coords_.pop_back();
+    firsts_.pop_back();
+    counts_.pop_back();
+    flags_.pop_back();
+    chunkData_.pop_back();
+    return index != last ? last : NONE;
+}
+
+void ChunkDrawTable::clear() {
+    coords_.clear();
+    firsts_.clear();
+    counts_.clear();
+    flags_.clear();
+    chunkData_.clear();
+    dirty_.clear();
+}
+
+void ChunkDrawTable::takeDirtyRanges(std::vector<ChunkDataRange>& out) {
+    out.clear();
+    std::sort(dirty_.begin(), dirty_.end());
+    const uint32_t n = static_cast<uint32_t>(size());
+    for (uint32_t index : dirty_) {
+        if (index >= n) break; // removed since it was flagged
+        flags_[index] &= ~DIRTY;
+        if (!out.empty() && index <= out.back().end + DIRTY_MERGE_GAP) {
+            out.back().end = std::max(out.back().end, index + 1);
+        }
+        else {
+            out.push_back({ index, index + 1 });
+        }
+    }
+    dirty_.clear();
+}
+
+void ChunkDrawTable::markDirty(uint32_t index) {
+    if (flags_[index] & DIRTY) return;
+    flags_[index] |= DIRTY;
+    dirty_.push_back(index);
+}
+
+void ChunkDrawTable::write(uint32_t index, const glm::ivec3& coords, uint32_t firstQuad, uint32_t quadCount) {
+    const int first = static_cast<int>(firstQuad) * 6;
+    const int count = static_cast<int>(quadCount) * 6;
+    coords_[index] = coords;
+    firsts_[index] = first;
+    counts_[index] = count;
+    flags_[index] = (flags_[index] & DIRTY) | (quadCount ? HAS_QUADS : 0);
+    markDirty(index);
+
+    ChunkData& d = chunkData_[index];
+    d.offset = glm::ivec4(coords, 0);
+    d.first = first;
+    d.count = count;
+    d.padding1 = 0;
+    d.padding2 = 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef CHUNK_DRAW_TABLE_H
+#define CHUNK_DRAW_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ChunkRenderBackend.h" // ChunkData
+
+// ----------------------------------------------------------------------------
+// ChunkDrawTable
+//
+// Dense structure-of-arrays list of every loaded chunk's draw, in the order the
+// MultiDraw call and the ChunkInfo SSBO use (entry i = gl_DrawID i).
+// - Updated only when a chunk is added, remeshed or removed; producing the
+//   per-frame draw lists is just handing out these arrays.
+// - Removal swaps the last entry into the hole, so the arrays stay packed.
+// - firsts/counts are in vertices (6 per quad), ready for glMultiDrawArrays.
+// - Entries written since the last takeDirtyRanges() are flagged DIRTY, so the
+//   GPU copy of chunkData() only needs those entries re-uploaded.
+// ----------------------------------------------------------------------------
+class ChunkDrawTable {
+public:
+    enum Flags : uint8_t {
+        HAS_QUADS = 1 << 0, // count > 0
+        DIRTY     = 1 << 1, // written since the last takeDirtyRanges()
+    };
+
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    // Append a chunk; returns its index
+    uint32_t add(const glm::ivec3& coords, uint32_t firstQuad, uint32_t quadCount);
+    void update(uint32_t index, uint32_t firstQuad, uint32_t quadCount);
+
+    // Swap-remove. Returns the old index of the entry that now sits at 'index'
+    // (its chunk must be told its new index), or NONE if nothing moved.
+    uint32_t remove(uint32_t index);
+
+    void clear();
+
+    // Sorted, coalesced ranges of the entries written since the last call
+    // (entries removed since are dropped); clears their DIRTY flags.
+    void takeDirtyRanges(std::vector<ChunkDataRange>& out);
+
+    size_t size() const { return coords_.size(); }
+    bool empty() const { return coords_.empty(); }
+
+    const glm::ivec3* coords() const { return coords_.data(); }
+    const int* firsts() const { return firsts_.data(); }
+    const int* counts() const { return counts_.data(); }
+    const uint8_t* flags() const { return flags_.data(); }
+    const ChunkData* chunkData() const { return chunkData_.data(); }
+
+private:
+    void markDirty(uint32_t index);
+    void write(uint32_t index, const glm::ivec3& coords, uint32_t firstQuad, uint32_t quadCount);
+
+    std::vector<glm::ivec3> coords_;
+    std::vector<int> firsts_;
+    std::vector<int> counts_;
+    std::vector<uint8_t> flags_;
+    std::vector<ChunkData> chunkData_; // same entries in the GPU layout
+    std::vector<uint32_t> dirty_;      // indices flagged DIRTY, unsorted, may be stale
+};
+
+#endif // CHUNK_DRAW_TABLE_H
@@ -1,7 +1,13 @@
 ﻿
 #include "ChunkHandler.h"
-#include <cstring>    // for std::memcpy
+#include <algorithm>  // for std::fill
+#include <climits>    // for INT_MAX, INT_MIN
+#include <cmath>      // for std::floor
+#include <cstring>    // for std::memcpy, std::memset
 #include <iostream>   // for debug logging (optional)
+#ifdef _MSC_VER
+#include <intrin.h>   // for _BitScanForward64
+#endif
 
 const int chunkSize = 62;
 // ----------------------------------------------------------------------------
@@ -23,167 +29,473 @@ ChunkHandler::ChunkHandler() = default;
 
 ChunkHandler::~ChunkHandler() { destroy(); }
 // ----------------------------------------------------------------------------
-// init(maxTotalQuads):
-//   - Creates a UniversalPool<uint64_t> with capacity = maxTotalQuads.
-//   - Allocates one GL SSBO of size (maxTotalQuads * sizeof(uint64_t)).
+// init(initialQuads, renderBackend, workerThreads, cpuQuadShadow):
+//   - Creates a UniversalPool<uint64_t> with capacity = initialQuads. It only
+//     tracks offsets; it owns a CPU copy of the quads only if cpuQuadShadow is set.
+//   - Starts the JobSystem used by generateChunks / addSDFEditAtWorldPos.
+//   - Lets the backend (if any) allocate its GPU buffers for the same capacity.
+//   Both grow together when an allocation does not fit (see growQuadHeap).
 // ----------------------------------------------------------------------------
-bool ChunkHandler::init(uint32_t maxTotalQuads) {
-    // maxTotalQuads is typically for vertex data, not metadata.
-    // Ensure UniversalPool and ChunkBufferManager are initialized correctly
+bool ChunkHandler::init(uint32_t initialQuads, IChunkRenderBackend* renderBackend,
+    unsigned workerThreads, bool cpuQuadShadow) {
+    // initialQuads is for vertex data, not metadata.
+    // Ensure UniversalPool and the backend are initialized correctly
     // with appropriate sizes for vertex data.
-    pool = new UniversalPool<uint64_t, true>(maxTotalQuads, /*ownsMemory=*/true);
+    pool = new UniversalPool<uint64_t, true>(initialQuads, /*ownsMemory=*/cpuQuadShadow);
     pool->reset();
-    bufferMgr.initialize(maxTotalQuads);
 
-    // Create the metadata SSBO
-    glCreateBuffers(1, &metadataSSBO);
+    jobs = std::make_unique<JobSystem>(workerThreads);
 
-    // Define a reasonable maximum for the number of chunks whose metadata will be stored.
-    // You should adjust MAX_METADATA_CHUNKS based on your application's expected
-    // maximum number of active chunks to avoid reallocations or insufficient space.
-    const size_t MAX_METADATA_CHUNKS = 10000; // Example: Supports up to 10,000 chunks for metadata
-
-    // Calculate the total buffer size for the metadata SSBO:
-    // - sizeof(uint32_t) for the 'chunkCount'
-    // - Plus 12 bytes of padding to ensure the 'ChunkData' array starts on a 16-byte boundary
-    //   (this is consistent with std430 layout rules and your glBufferSubData offset of 16).
-    // - Plus (MAX_METADATA_CHUNKS * sizeof(ChunkData)) for the array of 'ChunkData' structs.
-    // Each ChunkData struct is 32 bytes (glm::ivec4 (16 bytes) + 3 ints (12 bytes) + 4 bytes padding = 32 bytes).
-    size_t metadataBufferSize = 16 + MAX_METADATA_CHUNKS * sizeof(ChunkData);
+    backend = renderBackend;
+    if (backend && !backend->initialize(initialQuads)) {
+        backend = nullptr;
+        return false;
+    }
+    return true;
+}
 
-    // Allocate storage for the metadata SSBO
-    glNamedBufferStorage(metadataSSBO, metadataBufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+// Double the quad heap (or more, for one huge mesh) up to quadCapacityLimit
+bool ChunkHandler::growQuadHeap(uint32_t neededQuads) {
+    const uint64_t capacity = pool->getCapacity();
+    const uint64_t newCapacity = std::min<uint64_t>(quadCapacityLimit,
+        std::max<uint64_t>(capacity * 2, capacity + neededQuads));
+    if (newCapacity < capacity + neededQuads) return false; // limit reached
 
+    if (backend && !backend->growQuadCapacity(static_cast<uint32_t>(newCapacity))) return false;
+    pool->grow(static_cast<uint32_t>(newCapacity));
+    std::cout << "[ChunkHandler] Quad heap grown to " << newCapacity << " quads\n";
     return true;
 }
 
 
 void ChunkHandler::destroy() {
-    if (metadataSSBO) {
-        glDeleteBuffers(1, &metadataSSBO);
-        metadataSSBO = 0;
+    jobs.reset(); // joins the workers before the data they touch goes away
+    if (backend) {
+        backend->destroy();
+        backend = nullptr;
     }
-    bufferMgr.destroy();
     delete pool; pool = nullptr;
     chunkMap.clear();
+    drawTable.clear();
+    retiredAllocations.clear();
+    pendingUploads.clear();
+}
+
+// Key the backend files a chunk's quads under
+static uint64_t backendChunkKey(const glm::ivec3& coords) {
+    return (uint64_t(coords.x) & 0xFFFFF) << 40 |
+        (uint64_t(coords.y) & 0xFFFFF) << 20 |
+        (uint64_t(coords.z) & 0xFFFFF);
 }
 
 bool ChunkHandler::addOrUpdateChunk(const glm::ivec3& coords,
     const std::vector<uint64_t>& quads) {
-    auto it = chunkMap.find(coords);
+    std::vector<uint64_t> copy = takeQuadBuffer();
+    copy.assign(quads.begin(), quads.end());
+    return addOrUpdateChunk(coords, std::move(copy));
+}
 
-    // Common allocation logic
-    int nodeID;
-    if (!pool->allocate(nodeID, static_cast<uint32_t>(quads.size()))) {
-        return false; // Failed to allocate pool node
+bool ChunkHandler::addOrUpdateChunk(const glm::ivec3& coords,
+    std::vector<uint64_t>&& quads) {
+    // Common allocation logic. Empty meshes take no pool range (nodeID -1), so they
+    // never sit between blocks the compactor wants to merge.
+    int nodeID = -1;
+    if (!quads.empty() && !pool->allocate(nodeID, static_cast<uint32_t>(quads.size()))) {
+        // Ranges the GPU has finished with since the last endFrame may make room,
+        // otherwise the heap grows
+        releaseRetiredAllocations();
+        const uint32_t size = static_cast<uint32_t>(quads.size());
+        if (!pool->allocate(nodeID, size) && !(growQuadHeap(size) && pool->allocate(nodeID, size))) {
+            recycleQuadBuffer(std::move(quads));
+            return false; // Failed to allocate pool node
+        }
     }
-    uint32_t offset = static_cast<uint32_t>(pool->getBlock(nodeID).position);
 
-    uint64_t key = (uint64_t(coords.x) & 0xFFFFF) << 40 |
-        (uint64_t(coords.y) & 0xFFFFF) << 20 |
-        (uint64_t(coords.z) & 0xFFFFF);
-    bufferMgr.stageChunkData(key, quads, offset);
-
-    // Check if the chunk already exists
-    if (it != chunkMap.end()) {
-        // Chunk exists: Deallocate old mesh data from the pool
-        pool->deallocate(it->second.poolNodeID);
+    // The range is ours from here on, so the shadow copy can be written right away
+    if (nodeID >= 0 && pool->ownsMemory()) {
+        std::copy(quads.begin(), quads.end(), pool->getAddress(pool->getBlock(nodeID).position));
+    }
 
-        // Update the existing ChunkMetadata object with the new mesh data
-        // IMPORTANT: The sdfEdits vector of the existing 'it->second' is preserved.
-        it->second.poolNodeID = nodeID;
-        it->second.quadCount = static_cast<uint32_t>(quads.size());
-        it->second.ssboSlotOffset = offset;
-        // No need to touch it->second.sdfEdits as it already contains the history.
+    ChunkMetadata* md = chunkMap.find(coords);
+    if (!md) {
+        // Chunk does not exist: create it with nothing to draw until its quads are in
+        ChunkMetadata fresh;
+        fresh.chunkCoords = coords;
+        fresh.poolNodeID = -1;
+        fresh.quadCount = 0;
+        fresh.ssboSlotOffset = 0;
+        fresh.drawIndex = drawTable.add(coords, 0, 0);
+        md = &chunkMap.insertOrAssign(coords, std::move(fresh)); // no voxels yet
+    }
 
+    if (!backend) {
+        commitChunkQuads(*md, nodeID); // nothing to upload
+        recycleQuadBuffer(std::move(quads));
         return true;
     }
-    else {
-        // Chunk does not exist: Create a new ChunkMetadata object
-        ChunkMetadata md;
-        md.chunkCoords = coords;
-        md.poolNodeID = nodeID;
-        md.quadCount = static_cast<uint32_t>(quads.size());
-        md.ssboSlotOffset = offset;
-        md.sdfEdits.clear(); // For a brand new chunk, its SDF edits list is initially empty.
-        chunkMap[coords] = std::move(md); // Insert the new chunk metadata
 
-        return true;
+    // The chunk keeps drawing its current quads until flushUploads() has uploaded these.
+    // A newer update of the same chunk supersedes this one (see flushUploads).
+    md->pendingUpload = ++uploadSerial;
+    pendingUploads.push_back({ coords, md->pendingUpload, nodeID, std::move(quads) });
+    return true;
+}
+
+void ChunkHandler::commitChunkQuads(ChunkMetadata& md, int nodeID) {
+    // IMPORTANT: The resident voxels of an existing chunk are preserved.
+    // Its old mesh data is freed once no frame in flight draws it.
+    if (md.poolNodeID >= 0) retireAllocation(md.poolNodeID);
+
+    const MemoryBlock block = nodeID >= 0 ? pool->getBlock(nodeID) : MemoryBlock{ 0, 0 };
+    md.poolNodeID = nodeID;
+    md.quadCount = block.size;
+    md.ssboSlotOffset = block.position;
+    drawTable.update(md.drawIndex, md.ssboSlotOffset, md.quadCount);
+}
+
+void ChunkHandler::flushUploads() {
+    lastUploadBytes = 0;
+    if (pendingUploads.empty()) return;
+
+    // Oldest first, until the budget is used up (always at least one chunk, however big)
+    auto isCurrent = [&](const PendingUpload& p) {
+        const ChunkMetadata* md = chunkMap.find(p.coords);
+        return md && md->pendingUpload == p.serial;
+    };
+    size_t taken = 0;
+    uploadBatch.clear();
+    for (; taken < pendingUploads.size(); ++taken) {
+        PendingUpload& p = pendingUploads[taken];
+        if (!isCurrent(p)) {
+            if (p.poolNodeID >= 0) pool->deallocate(p.poolNodeID); // superseded or removed, never uploaded
+            continue;
+        }
+        const size_t bytes = p.quads.size() * sizeof(uint64_t);
+        if (uploadBudget && lastUploadBytes > 0 && lastUploadBytes + bytes > uploadBudget) break;
+        lastUploadBytes += bytes;
+
+        if (p.poolNodeID < 0) continue; // empty mesh: nothing to upload, committed below
+        const MemoryBlock block = pool->getBlock(p.poolNodeID);
+        uploadBatch.push_back({ backendChunkKey(p.coords), p.quads.data(), block.size, block.position });
+    }
+
+    // One staging write + copy set for the whole batch, then the chunks draw their new quads
+    backend->uploadChunkQuads(uploadBatch.data(), uploadBatch.size());
+    for (size_t i = 0; i < taken; ++i) {
+        PendingUpload& p = pendingUploads[i];
+        if (!isCurrent(p)) continue;
+        ChunkMetadata& md = *chunkMap.find(p.coords);
+        commitChunkQuads(md, p.poolNodeID);
+        md.pendingUpload = 0;
     }
+    for (size_t i = 0; i < taken; ++i) recycleQuadBuffer(std::move(pendingUploads[i].quads));
+    pendingUploads.erase(pendingUploads.begin(), pendingUploads.begin() + taken);
+}
+
+std::vector<uint64_t> ChunkHandler::takeQuadBuffer() {
+    if (spareQuadBuffers.empty()) return {};
+    std::vector<uint64_t> quads = std::move(spareQuadBuffers.back());
+    spareQuadBuffers.pop_back();
+    return quads;
+}
+
+void ChunkHandler::recycleQuadBuffer(std::vector<uint64_t>&& quads) {
+    if (quads.capacity() == 0 || spareQuadBuffers.size() >= maxSpareQuadBuffers) return;
+    quads.clear();
+    spareQuadBuffers.push_back(std::move(quads));
+}
+
+uint32_t ChunkHandler::compactQuadHeap(uint32_t maxMoves) {
+    if (!pool || maxMoves == 0) return 0;
+    const PoolStats stats = pool->getStats();
+    if (stats.freeBlockCount <= 1 || stats.fragmentation() < compactionThreshold) return 0;
+
+    // Meshes by heap position, highest first. Chunks with a queued upload are about to move anyway.
+    compactionCandidates.clear();
+    for (ChunkMetadata& md : chunkMap.values()) {
+        if (md.quadCount > 0 && md.poolNodeID >= 0 && md.pendingUpload == 0) compactionCandidates.push_back(&md);
+    }
+    std::sort(compactionCandidates.begin(), compactionCandidates.end(),
+        [](const ChunkMetadata* a, const ChunkMetadata* b) { return a->ssboSlotOffset > b->ssboSlotOffset; });
+
+    // The destination is always free, so no frame in flight reads it; the source is retired like after a remesh
+    auto move = [&](ChunkMetadata& md, int nodeID) {
+        const uint32_t dst = pool->getBlock(nodeID).position;
+        if (backend) backend->copyChunkQuads(md.ssboSlotOffset, dst, md.quadCount);
+        if (pool->ownsMemory()) {
+            std::copy_n(pool->getAddress(md.ssboSlotOffset), md.quadCount, pool->getAddress(dst));
+        }
+        commitChunkQuads(md, nodeID);
+    };
+
+    uint32_t moves = 0;
+    while (moves < maxMoves) {
+        MemoryBlock hole;
+        if (!pool->getLowestFreeBlock(hole)) break;
+        const uint32_t holeEnd = hole.position + hole.size;
+
+        // Fill the lowest hole with the highest-placed mesh that fits in it
+        ChunkMetadata* filler = nullptr;
+        for (ChunkMetadata*& md : compactionCandidates) {
+            if (!md) continue; // moved already
+            if (md->ssboSlotOffset < holeEnd) break;
+            if (md->quadCount <= hole.size) { filler = md; md = nullptr; break; }
+        }
+        int nodeID;
+        if (filler && pool->allocateLowest(nodeID, filler->quadCount, filler->ssboSlotOffset)) {
+            move(*filler, nodeID);
+            ++moves;
+            continue;
+        }
+
+        // Nothing fits: move the mesh right after the hole out of the way, so once
+        // its range is released the hole merges with it and grows
+        auto next = std::find_if(compactionCandidates.begin(), compactionCandidates.end(),
+            [&](const ChunkMetadata* md) { return md && md->ssboSlotOffset == holeEnd; });
+        if (next == compactionCandidates.end()) break; // retired range or the end of the heap: wait for the fences
+        ChunkMetadata& blocker = **next;
+        if (!pool->allocate(nodeID, blocker.quadCount)) break;
+        *next = nullptr;
+        move(blocker, nodeID);
+        ++moves;
+        break; // the hole only grows once the blocker's old range is released
+    }
+    return moves;
+}
+
+bool ChunkHandler::readChunkQuads(const glm::ivec3& coords, std::vector<uint64_t>& quadsOut) const {
+    const ChunkMetadata* md = chunkMap.find(coords);
+    if (!md || !pool || !pool->ownsMemory()) return false;
+    const uint64_t* first = md->quadCount ? pool->getAddress(md->ssboSlotOffset) : nullptr;
+    quadsOut.assign(first, first + md->quadCount);
+    return true;
+}
+
+PoolStats ChunkHandler::getQuadHeapStats() const {
+    return pool ? pool->getStats() : PoolStats{};
+}
+
+size_t ChunkHandler::getPendingUploadBytes() const {
+    size_t bytes = 0;
+    for (const PendingUpload& p : pendingUploads) bytes += p.quads.size() * sizeof(uint64_t);
+    return bytes;
 }
 
 
 void ChunkHandler::removeChunk(const glm::ivec3& coords) {
-    auto it = chunkMap.find(coords);
-    if (it != chunkMap.end()) {
-        pool->deallocate(it->second.poolNodeID);
-        chunkMap.erase(it);
+    if (ChunkMetadata* md = chunkMap.find(coords)) {
+        if (md->poolNodeID >= 0) retireAllocation(md->poolNodeID); // a queued upload is dropped by flushUploads
+        const uint32_t moved = drawTable.remove(md->drawIndex);
+        if (moved != ChunkDrawTable::NONE) {
+            // The last draw was swapped into this chunk's slot
+            chunkMap.find(drawTable.coords()[md->drawIndex])->drawIndex = md->drawIndex;
+        }
+        chunkMap.erase(coords);
     }
 }
 
 void ChunkHandler::clearAll() {
-    for (auto& kv : chunkMap) pool->deallocate(kv.second.poolNodeID);
+    for (ChunkMetadata& md : chunkMap.values()) {
+        if (md.poolNodeID >= 0) retireAllocation(md.poolNodeID);
+    }
+    for (PendingUpload& p : pendingUploads) {
+        if (p.poolNodeID >= 0) pool->deallocate(p.poolNodeID); // never uploaded
+    }
+    pendingUploads.clear();
     chunkMap.clear();
-    bufferMgr.clear();
+    drawTable.clear();
+    if (backend) backend->clear();
 }
 
+void ChunkHandler::endFrame() {
+    if (backend) backend->fenceFrame(frameIndex);
+    ++frameIndex;
+    releaseRetiredAllocations();
+}
+
+void ChunkHandler::retireAllocation(int poolNodeID) {
+    if (!backend) {
+        pool->deallocate(poolNodeID); // nothing reads the quads
+        return;
+    }
+    retiredAllocations.push_back({ poolNodeID, frameIndex });
+}
 
+void ChunkHandler::releaseRetiredAllocations() {
+    if (retiredAllocations.empty()) return;
+    const uint64_t done = backend ? backend->completedFrames() : frameIndex;
 
-void ChunkHandler::bindQuadsSSBO(GLuint bindingPoint) const {
-    bufferMgr.bind(bindingPoint);
+    size_t released = 0;
+    while (released < retiredAllocations.size() && retiredAllocations[released].frame < done) {
+        pool->deallocate(retiredAllocations[released].poolNodeID);
+        ++released;
+    }
+    retiredAllocations.erase(retiredAllocations.begin(), retiredAllocations.begin() + released);
 }
 
-void ChunkHandler::bindMetadataSSBO(GLuint bindingPoint) {
-    prepareMetadataBuffer();
-    uint32_t count = static_cast<uint32_t>(tempChunkData.size());
 
-    // Bind SSBO for update
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, metadataSSBO);
-    // Upload chunkCount (4 bytes)
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t), &count);
-    // Upload array of ChunkData starting at offset 16 (4 bytes count + 12 bytes padding)
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 16,
-        count * sizeof(ChunkData), tempChunkData.data());
-    // Bind SSBO to shader slot
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, metadataSSBO);
-    // Unbind target
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+void ChunkHandler::bindQuadsSSBO(uint32_t bindingPoint) const {
+    if (backend) backend->bindQuads(bindingPoint);
+}
+
+void ChunkHandler::bindMetadataSSBO(uint32_t bindingPoint) {
+    if (!backend) return;
+    uint32_t count = static_cast<uint32_t>(drawTable.size());
+
+    // Only the entries written since the last call go to the GPU
+    drawTable.takeDirtyRanges(dirtyMetadata);
+    metadataBytesUploaded = backend->updateChunkMetadata(drawTable.chunkData(), count, dirtyMetadata);
+    backend->bindMetadata(bindingPoint);
 }
 
 size_t ChunkHandler::getLoadedChunkCount() const {
     return chunkMap.size();
 }
 
-size_t ChunkHandler::retrieveFirstsAndCounts(std::vector<GLint>& firsts,
-    std::vector<GLsizei>& counts) const {
-    firsts.clear(); counts.clear();
-    firsts.reserve(chunkMap.size()); counts.reserve(chunkMap.size());
-    for (auto& kv : chunkMap) {
-        firsts.push_back(static_cast<GLint>(kv.second.ssboSlotOffset) * 6);
-        counts.push_back(static_cast<GLsizei>(kv.second.quadCount) * 6);
+size_t ChunkHandler::retrieveFirstsAndCounts(std::vector<int>& firsts,
+    std::vector<int>& counts) const {
+    firsts.assign(drawTable.firsts(), drawTable.firsts() + drawTable.size());
+    counts.assign(drawTable.counts(), drawTable.counts() + drawTable.size());
+    return drawTable.size();
+}
+
+// Copies the quads of a generateMeshData result out of the thread's workspace.
+// quadsOut keeps its capacity, so a recycled buffer is not reallocated.
+static void copyQuads(const MeshData& meshData, std::vector<uint64_t>& quadsOut) {
+    quadsOut.assign(meshData.vertices->begin(), meshData.vertices->begin() + meshData.vertexCount);
+}
+
+// Regenerated voxels replace the chunk's old ones and arrive idle: drop the per-layer
+// mesh of the old voxels (the next edit meshes in full) and the pending idle countdown
+static void resetEditState(ChunkMetadata& md) {
+    md.cpuMesh.clear();
+    md.touched = false;
+}
+
+bool ChunkHandler::generateChunk(const glm::ivec3& coords,
+    const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits) {
+    const ChunkFill fill = classifyChunk(coords, sharedNoise, sdfEdits);
+    if (fill != ChunkFill::Mixed) {
+        // Nothing to generate or mesh: a zero-quad entry and a single-material volume
+        if (!addOrUpdateChunk(coords, std::vector<uint64_t>())) return false;
+        ChunkMetadata& md = chunkMap[coords];
+        md.voxels.assignUniform(fill == ChunkFill::Solid ? terrainMaterial : 0);
+        resetEditState(md);
+        return true;
     }
-    return chunkMap.size();
+
+    MeshWorkspace& workspace = MeshWorkspace::forThread();
+    std::vector<uint8_t>& voxels = workspace.chunkVoxels();
+    std::vector<uint64_t>& opaqueMask = workspace.chunkMask();
+    generateVoxelsWithSDF(voxels, CS_P, CS_P2, CS_P3, coords * CS, sharedNoise, sdfEdits, opaqueMask.data());
+    assembleNeighborBorders(coords, voxels, opaqueMask.data(), nullptr);
+
+    std::vector<uint64_t> quads = takeQuadBuffer();
+    copyQuads(generateMeshData(voxels, opaqueMask.data()), quads);
+    if (!addOrUpdateChunk(coords, std::move(quads))) return false;
+
+    // Keep the voxels; new chunks start idle (compressed)
+    ChunkMetadata& md = chunkMap[coords];
+    md.voxels.assignCompressed(voxels.data());
+    resetEditState(md);
+    return remeshNeighborsOfEdits(coords, sdfEdits);
+}
+
+bool ChunkHandler::remeshNeighborsOfEdits(const glm::ivec3& coords,
+    const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits) {
+    static const glm::ivec3 faceDirs[6] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+    bool allSuccess = true;
+    for (const glm::ivec3& dir : faceDirs) {
+        const glm::ivec3 n = coords + dir;
+        ChunkMetadata* md = chunkMap.find(n);
+        if (!md || md->voxels.empty()) continue; // no neighbor, or one added from raw quads
+
+        // Only the padding plane facing this chunk can have changed, and only where an edit reached it
+        const ISDFEdit* edit = nullptr;
+        glm::ivec3 lo, hi;
+        for (const auto& edit_ptr : sdfEdits) {
+            if (edit_ptr && editLocalBounds(n * CS, *edit_ptr, lo, hi)) { edit = edit_ptr.get(); break; }
+        }
+        if (!edit) continue;
+
+        std::vector<uint64_t> quads = takeQuadBuffer();
+        remeshEditedChunk(*md, *edit, CS, quads);
+        md->touched = true; // hot now, compressed again once idle
+        if (!addOrUpdateChunk(n, std::move(quads))) {
+            std::cerr << "[ChunkHandler] ERROR: Failed to remesh neighbor of generated chunk: ("
+                << n.x << "," << n.y << "," << n.z << ")\n";
+            allSuccess = false;
+        }
+    }
+    return allSuccess;
+}
+
+bool ChunkHandler::generateChunks(const std::vector<glm::ivec3>& coords) {
+    struct GeneratedChunk {
+        std::vector<uint64_t> quads;
+        ChunkVoxels voxels;
+    };
+    std::vector<GeneratedChunk> results(coords.size());
+    for (GeneratedChunk& result : results) result.quads = takeQuadBuffer();
+
+    // Worker side: generate + mesh, touching nothing but results[i]
+    auto build = [&](size_t i) {
+        const ChunkFill fill = classifyChunk(coords[i], sharedNoise);
+        if (fill != ChunkFill::Mixed) {
+            // Buried or open sky: no voxels to generate, nothing to mesh
+            results[i].voxels.assignUniform(fill == ChunkFill::Solid ? terrainMaterial : 0);
+            return;
+        }
+
+        MeshWorkspace& workspace = MeshWorkspace::forThread(); // per-thread generation scratch
+        std::vector<uint8_t>& voxels = workspace.chunkVoxels();
+        std::vector<uint64_t>& opaqueMask = workspace.chunkMask();
+        // Voxels and masks in one sweep, so meshing never rescans the volume
+        generateVoxelsWithSDF(voxels, CS_P, CS_P2, CS_P3, coords[i] * CS, sharedNoise, {}, opaqueMask.data());
+        assembleNeighborBorders(coords[i], voxels, opaqueMask.data(), nullptr); // chunkMap is read-only here
+
+        copyQuads(generateMeshData(voxels, opaqueMask.data()), results[i].quads);
+
+        // New chunks start idle (compressed)
+        results[i].voxels.assignCompressed(voxels.data());
+    };
+    if (jobs) jobs->parallelFor(coords.size(), build);
+    else for (size_t i = 0; i < coords.size(); ++i) build(i);
+
+    // Calling thread: pool allocation + upload, in submission order
+    bool allSuccess = true;
+    for (size_t i = 0; i < coords.size(); ++i) {
+        if (!addOrUpdateChunk(coords[i], std::move(results[i].quads))) {
+            std::cerr << "[ChunkHandler] ERROR: Failed to add generated chunk: ("
+                << coords[i].x << "," << coords[i].y << "," << coords[i].z << ")\n";
+            allSuccess = false;
+            continue;
+        }
+        ChunkMetadata& md = chunkMap[coords[i]];
+        md.voxels = std::move(results[i].voxels);
+        resetEditState(md);
+    }
+    return allSuccess;
 }
 
-bool ChunkHandler::prepareChunkMesh(const glm::ivec3& coords) {
-    auto& md = chunkMap[coords];
-    std::vector<uint8_t> voxels(md.chunkCoords.x * md.chunkCoords.y * md.chunkCoords.z);
-    generateVoxelsWithSDF(voxels, 64, 64*64, 64*64*64, coords, sharedNoise, md.sdfEdits);
-    auto meshData = generateMeshData(voxels);
-    return addOrUpdateChunk(coords, *meshData.vertices);
+size_t ChunkHandler::getVoxelMemoryUsage() const {
+    size_t bytes = 0;
+    for (const ChunkMetadata& md : chunkMap.values()) bytes += md.voxels.memoryUsage();
+    return bytes;
 }
 
-void ChunkHandler::prepareMetadataBuffer() {
-    tempChunkData.clear();
-    tempChunkData.reserve(chunkMap.size());
-    for (auto& kv : chunkMap) {
-        ChunkData d;
-        d.offset = glm::ivec4(kv.first, 0);
-        d.first = kv.second.ssboSlotOffset * 6;
-        d.count = kv.second.quadCount * 6;
-        d.padding1 = 0;
-        d.padding2 = 0;
-        tempChunkData.push_back(d);
+void ChunkHandler::compressIdleChunks() {
+    for (ChunkMetadata& md : chunkMap.values()) {
+        if (md.touched) {
+            md.touched = false; // give it one more frame before compressing
+        }
+        else if (!md.voxels.empty() && !md.voxels.isCompressed()) {
+            md.voxels.compress();
+            md.cpuMesh.clear(); // remeshed in full if it gets edited again
+        }
     }
 }
 
@@ -195,6 +507,98 @@ struct AABB {
     int minY, maxY;
     int minZ, maxZ;
 };
+std::shared_ptr<const HeightmapTile> ChunkHandler::acquireHeightmap(glm::ivec3 chunkOffsetInVoxels, FastNoiseLite& noise) {
+    std::shared_ptr<const HeightmapTile> heightmap =
+        heightmapCache.find(&noise, chunkOffsetInVoxels.x, chunkOffsetInVoxels.z);
+    if (heightmap) return heightmap;
+
+    const int pad = 1;
+    // Precompute our “height mapping” constants
+    const float maxHeightGlobal = static_cast<float>(CS_P) / 2.0f;
+    const float baseHeightGlobal = static_cast<float>(CS_P) / 4.0f;
+
+    // The whole footprint is one batched call, same points as GetNoise((x - pad + offset) * scale, ...)
+    float heightNoise[CS_P * CS_P];
+    noise.GetNoiseGrid2D(heightNoise, chunkOffsetInVoxels.x - pad, chunkOffsetInVoxels.z - pad,
+        CS_P, CS_P, ChunkHandler::voxel_scale);
+    auto tile = std::make_shared<HeightmapTile>();
+    tile->minHeight = INT_MAX;
+    tile->maxHeight = INT_MIN;
+    for (int column = 0; column < CS_P * CS_P; ++column) {
+        float terrainHeightF = baseHeightGlobal + (heightNoise[column] * maxHeightGlobal * 2.0f);
+        const int height = static_cast<int>(std::floor(terrainHeightF));
+        tile->heights[column] = height;
+        tile->minHeight = std::min(tile->minHeight, height);
+        tile->maxHeight = std::max(tile->maxHeight, height);
+    }
+    return heightmapCache.insert(&noise, chunkOffsetInVoxels.x, chunkOffsetInVoxels.z, std::move(tile));
+}
+
+ChunkHandler::ChunkFill ChunkHandler::classifyChunk(const glm::ivec3& coords, FastNoiseLite& noise,
+    const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits) {
+    const int pad = 1;
+    const glm::ivec3 chunkOffsetInVoxels = coords * CS;
+    for (const auto& edit_ptr : sdfEdits) {
+        glm::ivec3 lo, hi;
+        if (editLocalBounds(chunkOffsetInVoxels, *edit_ptr, lo, hi)) return ChunkFill::Mixed;
+    }
+
+    // Padded voxel y range of the chunk, in world voxels; a column is solid up to its height
+    const int bottomY = chunkOffsetInVoxels.y - pad;
+    const int topY = bottomY + CS_P - 1;
+    std::shared_ptr<const HeightmapTile> heightmap = acquireHeightmap(chunkOffsetInVoxels, noise);
+    if (heightmap->maxHeight < bottomY) return ChunkFill::Air; // no faces whatever the neighbors hold
+    if (heightmap->minHeight < topY) return ChunkFill::Mixed;
+
+    // Buried: faces only appear where a resident neighbor (edited, say) has air on
+    // the plane that will become this chunk's padding. Absent ones are terrain too.
+    uint8_t plane[CS_P2];
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            glm::ivec3 neighborCoords = coords;
+            neighborCoords[axis] += side ? 1 : -1;
+            const ChunkMetadata* neighbor = chunkMap.find(neighborCoords);
+            if (!neighbor || neighbor->voxels.empty()) continue;
+            if (neighbor->voxels.isUniform()) {
+                if (neighbor->voxels.uniformValue() == 0) return ChunkFill::Mixed;
+                continue;
+            }
+            neighbor->voxels.readPlane(axis, side ? 1 : CS, plane);
+            for (int p = 0; p < CS_P2; ++p) {
+                if (plane[p] == 0) return ChunkFill::Mixed;
+            }
+        }
+    }
+    return ChunkFill::Solid;
+}
+
+// Index of the lowest set bit of v (v != 0)
+static inline int lowestSetBit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward64(&bit, v);
+    return static_cast<int>(bit);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Write one 64-voxel z row: material where bits is set, air elsewhere, a memset per run
+static void fillVoxelRow(uint8_t* row, uint64_t bits, uint8_t material) {
+    if (bits == ~0ull) {
+        std::memset(row, material, CS_P);
+        return;
+    }
+    std::memset(row, 0, CS_P);
+    while (bits) {
+        const int begin = lowestSetBit(bits);
+        const uint64_t gaps = ~(bits >> begin);
+        const int end = gaps ? begin + lowestSetBit(gaps) : CS_P;
+        std::memset(row + begin, material, end - begin);
+        bits = end < CS_P ? bits & (~0ull << end) : 0;
+    }
+}
+
 // Renamed and modified from generateTerrain to include SDF edits
 // Renamed and modified from generateTerrain to include SDF edits
 void ChunkHandler::generateVoxelsWithSDF(
@@ -204,120 +608,216 @@ void ChunkHandler::generateVoxelsWithSDF(
     int cs_p3_val,   // N^3
     glm::ivec3 chunkOffsetInVoxels, // This is the chunk's base world-voxel coordinate
     FastNoiseLite& noise,
-    const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits // Changed to base class pointer
+    const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits, // Changed to base class pointer
+    uint64_t* opaqueMask
 ) {
     auto start = std::chrono::high_resolution_clock::now();
     const int pad = 1; // Assuming padding is 1 voxel on each side
     const int N = cs_p_val; // Total size including padding, e.g., 64
 
-    // 1) Ensure the voxel buffer is exactly N^3, zero-filled
+    // 1) Ensure the voxel buffer is exactly N^3; every row is written below, so no clearing
     if (voxels.size() != static_cast<size_t>(cs_p3_val)) {
-        voxels.assign(cs_p3_val, 0);
-    }
-    else {
-        std::fill(voxels.begin(), voxels.end(), 0);
+        voxels.resize(cs_p3_val);
     }
+    // Heightmap as bit ranges: bit z of columnEndBits[x][e] = column (x, z) is solid for y in [0, e)
+    uint64_t columnEndBits[CS_P * (CS_P + 1)] = {};
 
-    int terrainMaterialType = 2; // Default material for terrain, as per original code
-
-    // 3) Precompute our “height mapping” constants
-    const float maxHeightGlobal = static_cast<float>(N) / 2.0f;
-    const float baseHeightGlobal = static_cast<float>(N) / 4.0f;
+    int terrainMaterialType = terrainMaterial; // Default material for terrain, as per original code
 
-    // 4) Generate base terrain and apply SDF edits in a single pass
+    // 3) Heightmap of the footprint: cached per (x, z), so only the first chunk of a
+    // vertical column samples the noise. No voxel is touched yet.
+    std::shared_ptr<const HeightmapTile> heightmap = acquireHeightmap(chunkOffsetInVoxels, noise);
     for (int z = 0; z < N; ++z) {
         for (int x = 0; x < N; ++x) {
-            float worldX_noise = (chunkOffsetInVoxels.x + (x - pad)) * ChunkHandler::voxel_scale;
-            float worldZ_noise = (chunkOffsetInVoxels.z + (z - pad)) * ChunkHandler::voxel_scale;
-            float noiseValue = noise.GetNoise(worldX_noise, worldZ_noise);
-            float terrainHeightF = baseHeightGlobal + (noiseValue * maxHeightGlobal * 2.0f);
-            int terrainHeightVoxel = static_cast<int>(std::floor(terrainHeightF));
-
-            for (int y = 0; y < N; ++y) {
-                size_t index = static_cast<size_t>(z + (x * cs_p_val) + (y * cs_p2_val));
-                uint8_t voxelMaterial = 0; // Default to air
-
-                // Determine base terrain material based *only* on height
-                int worldY_voxel = chunkOffsetInVoxels.y + (y - pad);
-                if (worldY_voxel <= terrainHeightVoxel) {
-                    voxelMaterial = static_cast<uint8_t>(terrainMaterialType);
-                }
+            const int terrainHeightVoxel = heightmap->heights[z * N + x];
 
-                // Apply SDF edits
-                // For each voxel, iterate through all SDF edits and apply them
+            // Solid from the bottom of the chunk up to the height: y in [0, solidEnd)
+            const int solidEnd = std::clamp(terrainHeightVoxel - (chunkOffsetInVoxels.y - pad) + 1, 0, N);
+            columnEndBits[x * (CS_P + 1) + solidEnd] |= 1ull << z;
+        }
+    }
+
+    // Rows straight from the column ranges: row (x, y) holds bit z of every column
+    // with solidEnd > y, so walking y downwards only ever adds bits. Each row is
+    // then written as runs, and doubles as its opaque mask.
+    for (int x = 0; x < N; ++x) {
+        uint64_t row = 0;
+        for (int y = N - 1; y >= 0; --y) {
+            row |= columnEndBits[x * (CS_P + 1) + y + 1];
+            fillVoxelRow(voxels.data() + x * cs_p_val + static_cast<size_t>(y) * cs_p2_val, row,
+                static_cast<uint8_t>(terrainMaterialType));
+            if (opaqueMask) opaqueMask[x + y * cs_p_val] = row;
+        }
+    }
+
+    // 4) Apply SDF edits in order; each only visits the voxels inside its bounds.
+    // Later edits overwrite earlier ones, same as evaluating them per voxel.
+    for (const auto& edit_ptr : sdfEdits) {
+        applySDFEdit(voxels, opaqueMask, chunkOffsetInVoxels, *edit_ptr);
+    }
+}
+
+bool ChunkHandler::editLocalBounds(glm::ivec3 chunkOffsetInVoxels, const ISDFEdit& edit,
+    glm::ivec3& lo, glm::ivec3& hi) {
+    const int pad = 1;
+    std::pair<glm::vec3, glm::vec3> bounds = edit.getApproximateWorldBounds();
+
+    // World bounds -> padded local voxel range, with one voxel of slack for rounding
+    lo = glm::ivec3(glm::floor(bounds.first / ChunkHandler::voxel_scale)) - chunkOffsetInVoxels + glm::ivec3(pad - 1);
+    hi = glm::ivec3(glm::ceil(bounds.second / ChunkHandler::voxel_scale)) - chunkOffsetInVoxels + glm::ivec3(pad + 1);
+    lo = glm::max(lo, glm::ivec3(0));
+    hi = glm::min(hi, glm::ivec3(CS_P - 1));
+    return lo.x <= hi.x && lo.y <= hi.y && lo.z <= hi.z;
+}
+
+void ChunkHandler::applySDFEdit(
+    std::vector<uint8_t>& voxels,
+    uint64_t* opaqueMask,
+    glm::ivec3 chunkOffsetInVoxels,
+    const ISDFEdit& edit
+) {
+    const int pad = 1;
+    glm::ivec3 lo, hi;
+    if (!editLocalBounds(chunkOffsetInVoxels, edit, lo, hi)) return; // edit misses this chunk
+
+    const uint8_t material = edit.getMaterial();
+    for (int y = lo.y; y <= hi.y; ++y) {
+        for (int x = lo.x; x <= hi.x; ++x) {
+            uint64_t written = 0; // z bits of this row that got the material
+            for (int z = lo.z; z <= hi.z; ++z) {
                 glm::vec3 worldVoxelPos_scaled = glm::vec3(
                     (chunkOffsetInVoxels.x + (x - pad)),
                     (chunkOffsetInVoxels.y + (y - pad)),
                     (chunkOffsetInVoxels.z + (z - pad))
                 ) * ChunkHandler::voxel_scale;
 
-                for (const auto& edit_ptr : sdfEdits) {
-                    float distance = edit_ptr->getSignedDistance(worldVoxelPos_scaled);
-                    if (distance <= 0.0f) { // Inside or on the surface of the SDF shape
-                        voxelMaterial = edit_ptr->getMaterial();
-                    }
+                if (edit.getSignedDistance(worldVoxelPos_scaled) <= 0.0f) { // Inside or on the surface of the SDF shape
+                    voxels[static_cast<size_t>(z + (x * CS_P) + (y * CS_P2))] = material;
+                    written |= 1ull << z;
                 }
-                voxels[index] = voxelMaterial;
+            }
+            if (opaqueMask && written) {
+                // The row's mask bit i is voxel z = i, same as buildOpaqueMask
+                uint64_t& rowMask = opaqueMask[x + y * CS_P];
+                rowMask = material ? (rowMask | written) : (rowMask & ~written);
             }
         }
     }
 }
 
-// NEW: Generic addSDFEditToChunk
-bool ChunkHandler::addSDFEditToChunk(glm::ivec3 chunkCoords, std::unique_ptr<ISDFEdit> edit,
+// Apply an edit to one chunk's resident voxels and remesh it
+bool ChunkHandler::addSDFEditToChunk(glm::ivec3 chunkCoords, const ISDFEdit& edit,
     int chunkSizeInVoxels, FastNoiseLite& noise) {
 
-    auto it = chunkMap.find(chunkCoords);
-    if (it == chunkMap.end()) {
+    ChunkMetadata* md = chunkMap.find(chunkCoords);
+    if (!md) {
         std::cerr << "[ChunkHandler] Warning: Attempted to add SDF edit to non-existent chunk: ("
             << chunkCoords.x << "," << chunkCoords.y << "," << chunkCoords.z << "). "
             << "Consider creating the chunk first.\n";
         return false;
     }
+    std::vector<uint64_t> quads = takeQuadBuffer();
+    applyEditToChunk(*md, edit, chunkSizeInVoxels, noise);
+    remeshEditedChunk(*md, edit, chunkSizeInVoxels, quads);
 
-    // Add the SDF edit to the chunk's list of edits
-    it->second.sdfEdits.push_back(std::move(edit)); // Move the unique_ptr
+    // Update the chunk in the handler (this will deallocate old memory and upload new)
+    bool success = addOrUpdateChunk(chunkCoords, std::move(quads));
 
-    // Re-calculate the world-voxel offset for this specific chunk
-    glm::ivec3 chunkOffsetInVoxels = chunkCoords * chunkSizeInVoxels;
+    if (!success) {
+        std::cerr << "[ChunkHandler] ERROR: Failed to update chunk after SDF edit: ("
+            << chunkCoords.x << "," << chunkCoords.y << "," << chunkCoords.z << ")\n";
+    }
+    return success;
+}
 
-    // Regenerate the mesh for this chunk using its updated SDF edits
-    MeshData newMeshData = generateVoxelMesh(1, chunkOffsetInVoxels, noise, it->second.sdfEdits);
 
-    // Update the chunk in the handler (this will deallocate old memory and upload new)
-    bool success = addOrUpdateChunk(chunkCoords, *newMeshData.vertices);
+void ChunkHandler::assembleNeighborBorders(glm::ivec3 coords, std::vector<uint8_t>& voxels,
+    uint64_t* opaqueMask, uint64_t* dirtyLayers) const {
+    uint8_t plane[CS_P2];
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            glm::ivec3 neighborCoords = coords;
+            neighborCoords[axis] += side ? 1 : -1;
+            const ChunkMetadata* neighbor = chunkMap.find(neighborCoords);
+            if (!neighbor || neighbor->voxels.empty()) continue;
+
+            // The -1 neighbor's last interior plane is our padding plane 0, the +1 neighbor's first is our last
+            neighbor->voxels.readPlane(axis, side ? 1 : CS, plane);
+            const int dst = side ? CS_P - 1 : 0;
+
+            bool changed = false;
+            for (int p = 0; p < CS_P2; ++p) {
+                const size_t v = ChunkVoxels::planeVoxelIndex(axis, dst, p);
+                if (voxels[v] == plane[p]) continue;
+                voxels[v] = plane[p];
+                changed = true;
+                if (opaqueMask) {
+                    const uint64_t bit = 1ull << (v % CS_P);
+                    if (plane[p]) opaqueMask[v / CS_P] |= bit;
+                    else opaqueMask[v / CS_P] &= ~bit;
+                }
+            }
 
-    // Clean up dynamically allocated MeshData members
-    if (newMeshData.vertices) {
-        delete newMeshData.vertices;
-        newMeshData.vertices = nullptr;
-    }
-    if (newMeshData.faceMasks) {
-        delete[] newMeshData.faceMasks;
-        newMeshData.faceMasks = nullptr;
-    }
-    if (newMeshData.opaqueMask) {
-        delete[] newMeshData.opaqueMask;
-        newMeshData.opaqueMask = nullptr;
-    }
-    if (newMeshData.forwardMerged) {
-        delete[] newMeshData.forwardMerged;
-        newMeshData.forwardMerged = nullptr;
+            // Only the outermost layer of the faces along this axis reads the padding plane
+            if (changed && dirtyLayers) {
+                const int face = axis == 1 ? 0 : axis == 0 ? 2 : 4;
+                const uint64_t layer = 1ull << (side ? CS - 1 : 0);
+                dirtyLayers[face] |= layer;
+                dirtyLayers[face + 1] |= layer;
+            }
+        }
     }
-    if (newMeshData.rightMerged) {
-        delete[] newMeshData.rightMerged;
-        newMeshData.rightMerged = nullptr;
+}
+
+void ChunkHandler::applyEditToChunk(ChunkMetadata& md, const ISDFEdit& edit,
+    int chunkSizeInVoxels, FastNoiseLite& noise) {
+    // Re-calculate the world-voxel offset for this specific chunk
+    glm::ivec3 chunkOffsetInVoxels = md.chunkCoords * chunkSizeInVoxels;
+
+    // Chunks that were added from raw quads have no voxels yet: materialize them once
+    if (md.voxels.empty()) {
+        std::vector<uint8_t> voxels(CS_P3);
+        std::vector<uint64_t> opaqueMask(CS_P2);
+        generateVoxelsWithSDF(voxels, CS_P, CS_P2, CS_P3, chunkOffsetInVoxels, noise, {}, opaqueMask.data());
+        md.voxels.assign(std::move(voxels), std::move(opaqueMask));
     }
 
-    if (!success) {
-        std::cerr << "[ChunkHandler] ERROR: Failed to update chunk after SDF edit: ("
-            << chunkCoords.x << "," << chunkCoords.y << "," << chunkCoords.z << ")\n";
+    // Only the voxels (and mask bits) inside the edit bounds change
+    std::vector<uint64_t>& opaqueMask = md.voxels.opaqueMask();
+    applySDFEdit(md.voxels.raw(), opaqueMask.data(), chunkOffsetInVoxels, edit);
+    md.touched = true;
+}
+
+void ChunkHandler::remeshEditedChunk(ChunkMetadata& md, const ISDFEdit& edit,
+    int chunkSizeInVoxels, std::vector<uint64_t>& quadsOut) {
+    glm::ivec3 chunkOffsetInVoxels = md.chunkCoords * chunkSizeInVoxels;
+    std::vector<uint64_t>& opaqueMask = md.voxels.opaqueMask(); // already hot from applyEditToChunk
+
+    // Seams follow the neighbors' real contents, whatever edits they have had
+    uint64_t dirtyLayers[6] = {};
+    assembleNeighborBorders(md.chunkCoords, md.voxels.raw(), opaqueMask.data(), dirtyLayers);
+
+    if (md.cpuMesh.empty()) {
+        // First edit since the chunk went hot: full mesh, kept per layer from now on
+        const MeshData& meshData = generateMeshData(md.voxels.raw(), opaqueMask.data());
+        md.cpuMesh.assign(meshData.vertices->data(), meshData.vertexCount);
     }
-    return success;
+    else {
+        // Remesh only the layers the edit (or a changed border) can reach and splice them in
+        glm::ivec3 lo, hi;
+        if (editLocalBounds(chunkOffsetInVoxels, edit, lo, hi)) {
+            uint64_t editLayers[6];
+            ChunkMesh::dirtyLayersForBox(lo.x, lo.y, lo.z, hi.x, hi.y, hi.z, editLayers);
+            for (int face = 0; face < 6; ++face) dirtyLayers[face] |= editLayers[face];
+        }
+        const MeshData& meshData = generateMeshData(md.voxels.raw(), opaqueMask.data(), dirtyLayers);
+        md.cpuMesh.splice(dirtyLayers, meshData.vertices->data(), meshData.vertexCount);
+    }
+    quadsOut = md.cpuMesh.quads();
 }
 
 
-MeshData ChunkHandler::generateVoxelMesh(
+const MeshData& ChunkHandler::generateVoxelMesh(
     int option,
     glm::ivec3 chunkOffsetInVoxels,
     FastNoiseLite& noise,
@@ -351,27 +851,13 @@ MeshData ChunkHandler::generateVoxelMesh(
 
 void ChunkHandler::profileOpaqueMaskGeneration(
     const std::vector<uint8_t>& voxels,
-    int CS_P,
-    int CS_P2,
     MeshData& meshData
 ) {
     // Start timing
     auto start = std::chrono::high_resolution_clock::now();
 
-    for (int z = 0; z < CS_P; ++z) {
-        for (int y = 0; y < CS_P; ++y) {
-            uint64_t bits = 0;
-            for (int x = 0; x < CS_P; ++x) {
-                // Accessing voxels[x + (y * CS_P) + (z * CS_P2)] implies a Z-major, then Y, then X ordering.
-                // Ensure this matches how your voxels are actually stored if performance is critical.
-                // For typical cache-friendly access, X should be the innermost loop.
-                if (voxels[x + (y * CS_P) + (z * CS_P2)]) {
-                    bits |= (1ull << x);
-                }
-            }
-            meshData.opaqueMask[y + z * CS_P] = bits;
-        }
-    }
+    // Same pass as generateMeshData (shared with the headless benchmark).
+    buildOpaqueMask(voxels.data(), meshData.opaqueMask);
 
     // Stop timing
     auto end = std::chrono::high_resolution_clock::now();
@@ -385,53 +871,27 @@ void ChunkHandler::profileOpaqueMaskGeneration(
 
 
 // The function
-MeshData ChunkHandler::generateMeshData(const std::vector<uint8_t>& voxels) {
-    MeshData meshData;
-
-    // Allocate memory
-    meshData.faceMasks = new uint64_t[CS_2 * 6];
-    meshData.opaqueMask = new uint64_t[CS_P2];
-    meshData.forwardMerged = new uint8_t[CS_2];
-    meshData.rightMerged = new uint8_t[CS];
-
-    // Calculate maxVertices
-    meshData.maxVertices = static_cast<size_t>(CS_P) * CS_P * CS_P * 6 / 2;
-    if (meshData.maxVertices < 1024) {
-        meshData.maxVertices = 1024;
-    }
-    meshData.vertices = new BM_VECTOR<uint64_t>(meshData.maxVertices);
-
-    // Initialize allocated memory to zero
-    memset(meshData.faceMasks, 0, sizeof(uint64_t) * CS_2 * 6);
-    memset(meshData.opaqueMask, 0, sizeof(uint64_t) * CS_P2);
-    memset(meshData.forwardMerged, 0, sizeof(uint8_t) * CS_2);
-    memset(meshData.rightMerged, 0, sizeof(uint8_t) * CS);
-
-    // Profile opaque mask generation
-    for (int z = 0; z < CS_P; ++z) {
-        for (int y = 0; y < CS_P; ++y) {
-            uint64_t bits = 0;
-            for (int x = 0; x < CS_P; ++x) {
-                // Accessing voxels[x + (y * CS_P) + (z * CS_P2)] implies a Z-major, then Y, then X ordering.
-                // Ensure this matches how your voxels are actually stored if performance is critical.
-                // For typical cache-friendly access, X should be the innermost loop.
-                if (voxels[x + (y * CS_P) + (z * CS_P2)]) {
-                    bits |= (1ull << x);
-                }
-            }
-            meshData.opaqueMask[y + z * CS_P] = bits;
-        }
-    }
+const MeshData& ChunkHandler::generateMeshData(const std::vector<uint8_t>& voxels) {
+    // Scratch buffers are allocated once per thread and reused
+    MeshData& meshData = MeshWorkspace::forThread().reset();
+
+    // Build the per-column opaque bitmasks that mesh() culls against
+    buildOpaqueMask(voxels.data(), meshData.opaqueMask);
 
 
     // Call the mesh function
     mesh(voxels.data(), meshData);
 
-    // Trim the vertices vector
-    if (meshData.vertices) {
-        meshData.vertices->resize(meshData.vertexCount);
-        meshData.vertices->shrink_to_fit();
-    }
+    return meshData;
+}
+
+const MeshData& ChunkHandler::generateMeshData(const std::vector<uint8_t>& voxels, const uint64_t* opaqueMask,
+    const uint64_t* dirtyLayers) {
+    MeshData& meshData = MeshWorkspace::forThread().reset();
+
+    // mesh() only reads the masks, so the chunk's own can be used in place
+    meshData.opaqueMask = const_cast<uint64_t*>(opaqueMask);
+    mesh(voxels.data(), meshData, dirtyLayers);
 
     return meshData;
 }
@@ -442,7 +902,7 @@ MeshData ChunkHandler::generateMeshData(const std::vector<uint8_t>& voxels) {
 // It identifies all affected chunks and their neighbors, then applies the edit.
 // ----------------------------------------------------------------------------
 bool ChunkHandler::addSDFEditAtWorldPos(const ISDFEdit& edit, int chunkSizeInVoxels, FastNoiseLite& noise) {
-    bool allSuccess;
+    bool allSuccess = true;
     // Get the tight world-space bounding box from the generic SDF edit object.
     std::pair<glm::vec3, glm::vec3> bounds = edit.getApproximateWorldBounds();
     glm::vec3 worldMin = bounds.first;
@@ -471,40 +931,62 @@ bool ChunkHandler::addSDFEditAtWorldPos(const ISDFEdit& edit, int chunkSizeInVox
         static_cast<int>(std::floor(worldMax.z / chunkWorldSize))
     );
 
-    // Populate uniqueChunksToProcess directly from this single expanded bounding box
-    std::unordered_set<glm::ivec3, IVec3Hash, IVec3Eq> uniqueChunksToProcess;
+    // Every chunk of this single expanded bounding box, each exactly once
+    std::vector<glm::ivec3> chunksToProcess;
     for (int cx = minChunkCoords.x; cx <= maxChunkCoords.x; ++cx) {
         for (int cy = minChunkCoords.y; cy <= maxChunkCoords.y; ++cy) {
             for (int cz = minChunkCoords.z; cz <= maxChunkCoords.z; ++cz) {
-                uniqueChunksToProcess.insert(glm::ivec3(cx, cy, cz));
+                chunksToProcess.push_back(glm::ivec3(cx, cy, cz));
             }
         }
     }
 
-    std::cout << "--- Processing " << uniqueChunksToProcess.size() << " chunks for SDF edit ---\n";
-    for (const auto& currentChunkCoords : uniqueChunksToProcess) {
-        // Clone the ISDFEdit object for each chunk. This is crucial because
-        // `addSDFEditToChunk` takes ownership of the `unique_ptr`.
-        // Each chunk's `sdfEdits` vector needs its own copy of the edit.
-        std::unique_ptr<ISDFEdit> clonedEdit = edit.clone();
-        if (!clonedEdit) {
-            std::cerr << "Error: Failed to clone SDF edit for chunk: ("
-                << currentChunkCoords.x << ", " << currentChunkCoords.y << ", " << currentChunkCoords.z << ")\n";
-            allSuccess = false;
-            continue; // Skip to next chunk if cloning failed
-        }
+    std::cout << "--- Processing " << chunksToProcess.size() << " chunks for SDF edit ---\n";
 
-        // Call the generic function to apply the SDF edit to this specific chunk.
-        if (!addSDFEditToChunk(currentChunkCoords, std::move(clonedEdit), chunkSizeInVoxels, noise)) {
-            // If addSDFEditToChunk fails for any reason (e.g., chunk not found, allocation error),
-            // we note it but continue trying for other chunks.
+    // Look the chunks up here; the workers only ever see their own ChunkMetadata
+    std::vector<ChunkMetadata*> targets;
+    targets.reserve(chunksToProcess.size());
+    for (const auto& currentChunkCoords : chunksToProcess) {
+        ChunkMetadata* md = chunkMap.find(currentChunkCoords);
+        if (!md) {
             std::cerr << "Error: Failed to apply SDF edit to chunk: ("
                 << currentChunkCoords.x << "," << currentChunkCoords.y << "," << currentChunkCoords.z << ")\n";
             allSuccess = false;
+            continue;
+        }
+        targets.push_back(md);
+    }
+
+    // The edit is written straight into each chunk's voxels on the workers. All chunks
+    // are edited before any is remeshed, so the border planes read from neighbors are final.
+    std::vector<std::vector<uint64_t>> quads(targets.size());
+    for (std::vector<uint64_t>& q : quads) q = takeQuadBuffer();
+    auto applyPass = [&](size_t i) {
+        applyEditToChunk(*targets[i], edit, chunkSizeInVoxels, noise);
+    };
+    auto remeshPass = [&](size_t i) {
+        remeshEditedChunk(*targets[i], edit, chunkSizeInVoxels, quads[i]);
+    };
+    if (jobs) {
+        jobs->parallelFor(targets.size(), applyPass);
+        jobs->parallelFor(targets.size(), remeshPass);
+    }
+    else {
+        for (size_t i = 0; i < targets.size(); ++i) applyPass(i);
+        for (size_t i = 0; i < targets.size(); ++i) remeshPass(i);
+    }
+
+    // Allocation + upload stay on this thread. On failure we note it but continue with the other chunks.
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const glm::ivec3 c = targets[i]->chunkCoords;
+        if (!addOrUpdateChunk(c, std::move(quads[i]))) {
+            std::cerr << "[ChunkHandler] ERROR: Failed to update chunk after SDF edit: ("
+                << c.x << "," << c.y << "," << c.z << ")\n";
+            allSuccess = false;
         }
     }
 
-    std::cout << "Total chunks marked for regeneration (or processed): " << uniqueChunksToProcess.size() << "\n";
+    std::cout << "Total chunks marked for regeneration (or processed): " << chunksToProcess.size() << "\n";
 
     return allSuccess;
 }
@@ -3,115 +3,25 @@
 #define CHUNK_HANDLER_H
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <chrono> // For high-resolution timer
-#include <glm/vec3.hpp>
-#include <glad/glad.h>
+#include <glm/glm.hpp>
 #include "UniversalPool.h"
 #include <glm/ext/vector_int4.hpp>
 #include <random>  // For random number generation
-#include <glm/gtx/norm.hpp>  // For glm::distance, glm::distance2, etc. (often needed)
 #include "FastNoiseLite.h"
 #include "mesher.h"
-#include "ChunkBufferManager.h"
-
-
-
-// ----------------------------------------------------------------------------
-// Base SDF Edit Interface
-// ----------------------------------------------------------------------------
-struct ISDFEdit {
-    // Pure virtual function to get the signed distance from a world point to the SDF shape
-    virtual float getSignedDistance(glm::vec3 point) const = 0;
-    // Pure virtual function to get the material type for the SDF shape
-    virtual uint8_t getMaterial() const = 0;
-
-    // NEW: Pure virtual function to get the approximate world-space bounding box of the SDF shape.
-    // This is crucial for the generic `addSDFEditAtWorldPos` to determine affected chunks.
-    // Returns a pair of glm::vec3: first is min, second is max.
-    virtual std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const = 0;
-
-    // NEW: Pure virtual function to clone the object polymorphically.
-    // This is necessary because addSDFEditAtWorldPos needs to make copies
-    // of the ISDFEdit object for each chunk it affects.
-    virtual std::unique_ptr<ISDFEdit> clone() const = 0;
-
-    // Virtual destructor for proper polymorphic deletion
-    virtual ~ISDFEdit() = default;
-};
-
-// ----------------------------------------------------------------------------
-// SDF Sphere Edit Structure
-// Inherits from ISDFEdit
-// ----------------------------------------------------------------------------
-struct SDFSphereEdit : public ISDFEdit {
-    glm::vec3 center;  // World coordinates of the sphere's center
-    float radius;      // Radius of the sphere
-    uint8_t material;  // Material type (0 for air, non-zero for solid)
-
-    // Constructor
-    SDFSphereEdit(glm::vec3 c, float r, uint8_t m) : center(c), radius(r), material(m) {}
-
-    // Implement getSignedDistance for sphere
-    float getSignedDistance(glm::vec3 point) const override {
-        return glm::distance(point, center) - radius;
-    }
-
-    // Implement getMaterial for sphere
-    uint8_t getMaterial() const override {
-        return material;
-    }
-
-    // Implement getApproximateWorldBounds for sphere
-    std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const override {
-        glm::vec3 worldMin = center - glm::vec3(radius);
-        glm::vec3 worldMax = center + glm::vec3(radius);
-        return { worldMin, worldMax };
-    }
-
-    // Implement clone for SDFSphereEdit
-    std::unique_ptr<ISDFEdit> clone() const override {
-        return std::make_unique<SDFSphereEdit>(*this); // Use copy constructor
-    }
-};
-
-// ----------------------------------------------------------------------------
-// SDF Cube Edit Structure
-// Inherits from ISDFEdit
-// ----------------------------------------------------------------------------
-struct SDFCubeEdit : public ISDFEdit {
-    glm::vec3 center;     // World coordinates of the cube's center
-    glm::vec3 halfExtents;  // Half-extents of the cube along each axis
-    uint8_t material;     // Material type (0 for air, non-zero for solid)
-
-    // Constructor
-    SDFCubeEdit(glm::vec3 c, glm::vec3 he, uint8_t m) : center(c), halfExtents(he), material(m) {}
-
-    // Implement getSignedDistance for cube (based on standard SDF for AABB)
-    float getSignedDistance(glm::vec3 p) const override {
-        glm::vec3 q = glm::abs(p - center) - halfExtents;
-        return glm::length(glm::max(q, 0.0f)) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f);
-    }
-
-    // Implement getMaterial for cube
-    uint8_t getMaterial() const override {
-        return material;
-    }
-
-    // Implement getApproximateWorldBounds for cube
-    std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const override {
-        glm::vec3 worldMin = center - halfExtents;
-        glm::vec3 worldMax = center + halfExtents;
-        return { worldMin, worldMax };
-    }
-
-    // Implement clone for SDFCubeEdit
-    std::unique_ptr<ISDFEdit> clone() const override {
-        return std::make_unique<SDFCubeEdit>(*this); // Use copy constructor
-    }
-};
+#include "SDFEdit.h"
+#include "ChunkRenderBackend.h"
+#include "ChunkVoxels.h"
+#include "ChunkMesh.h"
+#include "FlatChunkMap.h"
+#include "ChunkDrawTable.h"
+#include "HeightmapCache.h"
+#include "JobSystem.h"
+#include "MeshWorkspace.h"
 
 
 
@@ -120,64 +30,35 @@ struct SDFCubeEdit : public ISDFEdit {
 
 // ----------------------------------------------------------------------------
 // Per-chunk metadata: stores SSBO-offset + quad-count + chunk-coords
+// plus the chunk's materialized voxels (edits are applied to these directly)
 // ----------------------------------------------------------------------------
 struct ChunkMetadata {
     glm::ivec3 chunkCoords;
-    int poolNodeID;
+    int poolNodeID;           // -1 while the chunk has no quads in the heap
     uint32_t quadCount;
     uint32_t ssboSlotOffset;
-    std::vector<std::unique_ptr<ISDFEdit>> sdfEdits; // Now stores unique_ptrs to base interface
-};
-
-// ----------------------------------------------------------------------------
-// Hash & equality for glm::ivec3 so we can use it as key in std::unordered_map
-// ----------------------------------------------------------------------------
-struct IVec3Hash {
-    size_t operator()(glm::ivec3 const& v) const noexcept {
-        uint64_t x = static_cast<uint64_t>(v.x);
-        uint64_t y = static_cast<uint64_t>(v.y);
-        uint64_t z = static_cast<uint64_t>(v.z);
-        uint64_t h = (x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u);
-        return static_cast<size_t>(h);
-    }
-};
-struct IVec3Eq {
-    bool operator()(glm::ivec3 const& a, glm::ivec3 const& b) const noexcept {
-        return a.x == b.x && a.y == b.y && a.z == b.z;
-    }
-};
-
-// ----------------------------------------------------------------------------
-// Struct for GPU-side per-chunk metadata
-// Must match this layout exactly in GLSL:
-//
-// struct ChunkData {
-//     ivec3 offset; // chunk coordinates
-//     int   first;  // first vertex index in draw
-//     int   count;  // vertex count for draw
-// };
-//
-// layout(std430, binding = 2) buffer ChunkInfo {
-//     uint       chunkCount;
-//     ChunkData  data[];
-// };
-// ----------------------------------------------------------------------------
-struct ChunkData {
-    glm::ivec4 offset;  // Change to glm::ivec4 to match GLSL's 16-byte alignment
-    int        first;
-    int        count;
-    int        padding1; // Add padding to make struct 32 bytes
-    int        padding2; // Add padding to make struct 32 bytes
+    uint32_t drawIndex;       // entry in ChunkHandler's ChunkDrawTable
+    uint32_t pendingUpload = 0; // serial of the queued upload of newer quads, 0 = none
+    ChunkVoxels voxels;       // empty for chunks added from raw quads only
+    bool touched = false;     // edited since the last compressIdleChunks()
+    ChunkMesh cpuMesh;        // per-layer quads while hot, so small edits splice instead of remeshing
 };
 
 // ----------------------------------------------------------------------------
 // ChunkHandler
 //
-// - Manages one large SSBO of uint64_t-encoded quads.
-// - Sub-allocates per-chunk via UniversalPool<uint64_t> (1 slot = 1 quad).
+// - GL-free core: builds and runs without a window (see IChunkRenderBackend).
+// - Sub-allocates per-chunk quad ranges via UniversalPool<uint64_t> (1 slot = 1 quad),
+//   growing pool and GPU buffer geometrically instead of failing.
+//   The pool offset is where the backend writes the quads; freed ranges wait
+//   for the backend's frame fences before the pool may hand them out again.
+// - New meshes are queued and uploaded in one budgeted batch per frame (flushUploads).
+// - compactQuadHeap moves a few meshes per frame down the heap to undo fragmentation.
 // - Tracks per-chunk metadata (coords, ssboOffset, quadCount, poolNodeID).
-// - Prepares & uploads a second SSBO of per-chunk metadata for MultiDraw.
-// - Exposes methods to retrieve CPU-side arrays for firsts and counts.
+// - Keeps a ChunkDrawTable (firsts, counts, ChunkData) in sync with the chunks,
+//   so the per-frame MultiDraw lists and metadata need no rebuilding.
+// - Generation and meshing of batches (startup, multi-chunk edits) run on a
+//   JobSystem; pool allocation and backend uploads stay on the calling thread.
 // ----------------------------------------------------------------------------
 class ChunkHandler {
 public:
@@ -190,36 +71,105 @@ public:
     ChunkHandler();
     ~ChunkHandler();
 
-    // Initialize CPU pool and GPU ring buffer
-    bool init(uint32_t maxTotalQuads);
+    // Initialize CPU pool and, if a backend is given, its GPU buffers.
+    // initialQuads is only the starting size: the quad heap doubles whenever a
+    // mesh does not fit, up to setQuadCapacityLimit().
+    // Passing no backend runs headless (meshing and bookkeeping only).
+    // workerThreads = 0 sizes the job system from the core count.
+    // cpuQuadShadow keeps a CPU copy of the quad heap for readChunkQuads (readback,
+    // persistence); without it the pool only tracks offsets and uses no quad memory.
+    bool init(uint32_t initialQuads, IChunkRenderBackend* renderBackend = nullptr,
+        unsigned workerThreads = 0, bool cpuQuadShadow = false);
+    void setQuadCapacityLimit(uint32_t maxQuads) { quadCapacityLimit = maxQuads; }
     void destroy();
 
-    // Add or update a chunk's quad data
+    // Generate a chunk's voxels from noise (+ optional edits), mesh it and keep
+    // the voxels resident so later edits don't have to regenerate it.
+    // Resident neighbors whose border an edit reaches are remeshed against the new chunk.
+    bool generateChunk(const glm::ivec3& coords,
+        const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits = {});
+
+    // Same as generateChunk for many chunks: generation + meshing run on the
+    // worker threads, allocation and upload happen here. Returns false if any chunk failed.
+    bool generateChunks(const std::vector<glm::ivec3>& coords);
+
+    // What a chunk generates to, decided from its heightmap's min/max height alone
+    enum class ChunkFill {
+        Mixed, // needs the full generate + mesh path
+        Air,   // every padded voxel is air: no quads
+        Solid, // every padded voxel is terrain and no resident neighbor exposes a face: no quads
+    };
+
+    // Cheap pre-pass of generateChunk(s): uniform chunks skip voxel generation and
+    // meshing and are stored as a single material with a zero-quad draw entry.
+    // Any edit whose bounds reach the chunk makes it Mixed.
+    ChunkFill classifyChunk(const glm::ivec3& coords, FastNoiseLite& noise,
+        const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits = {});
+    static constexpr uint8_t terrainMaterial = 2; // material of generated terrain
+
+    // Add or update a chunk's quad data. With a backend the quads are queued and
+    // go to the GPU in the next flushUploads(); until then the chunk draws its old quads.
     bool addOrUpdateChunk(const glm::ivec3& coords,
         const std::vector<uint64_t>& quads);
+    bool addOrUpdateChunk(const glm::ivec3& coords,
+        std::vector<uint64_t>&& quads);
     void removeChunk(const glm::ivec3& coords);
     void clearAll();
 
-    // Bind SSBOs for rendering
-    void bindQuadsSSBO(GLuint bindingPoint) const;
-    void bindMetadataSSBO(GLuint bindingPoint);
+    // Upload the queued chunk meshes as one batch, oldest first, up to the
+    // per-frame upload budget. Call once per frame before drawing.
+    void flushUploads();
+    void setUploadBudget(size_t bytesPerFrame) { uploadBudget = bytesPerFrame; } // 0 = unlimited
+    size_t getUploadedBytes() const { return lastUploadBytes; } // by the last flushUploads
+    size_t getPendingUploadBytes() const;
+
+    // Relocate up to maxMoves chunk meshes (GPU-side copy) so free space merges
+    // into large blocks instead of leaving allocation to fail: the lowest hole is
+    // filled with the highest-placed mesh that fits, or the mesh right after it is
+    // moved away so the hole can grow. Call once per frame; returns moves made.
+    // Does nothing while getQuadHeapStats().fragmentation() is below the threshold.
+    uint32_t compactQuadHeap(uint32_t maxMoves);
+    void setCompactionThreshold(float fragmentation) { compactionThreshold = fragmentation; }
+    PoolStats getQuadHeapStats() const; // largest free block vs total free etc.
+
+    // Quads the chunk currently draws, from the CPU shadow; false without one (see init)
+    bool readChunkQuads(const glm::ivec3& coords, std::vector<uint64_t>& quadsOut) const;
+
+    // Call once per frame after the chunk draws were submitted. Quad ranges freed
+    // by updates/removals are only reused once the GPU has finished every frame
+    // that could still draw them.
+    void endFrame();
+
+    // Bind SSBOs for rendering (no-ops when headless).
+    // bindMetadataSSBO also uploads the ChunkData entries that changed since its last call.
+    void bindQuadsSSBO(uint32_t bindingPoint) const;
+    void bindMetadataSSBO(uint32_t bindingPoint);
+    size_t getMetadataBytesUploaded() const { return metadataBytesUploaded; } // by the last bindMetadataSSBO
 
     // Info
     size_t getLoadedChunkCount() const;
-    size_t retrieveFirstsAndCounts(std::vector<GLint>& firsts,
-        std::vector<GLsizei>& counts) const;
-
-
-
-
-
-
-
-
-
-
-
-    // Helper to generate voxel data, now accepts the base ISDFEdit vector
+    size_t retrieveFirstsAndCounts(std::vector<int>& firsts,
+        std::vector<int>& counts) const; // copies; prefer getDrawTable()
+    // Draw lists of all loaded chunks, kept up to date on add/update/remove
+    const ChunkDrawTable& getDrawTable() const { return drawTable; }
+
+    // Heightmap tiles reused by vertically stacked chunks (see generateVoxelsWithSDF).
+    // Clear it after changing the settings of a noise used for generation.
+    HeightmapCache& getHeightmapCache() { return heightmapCache; }
+    size_t getVoxelMemoryUsage() const; // resident voxel bytes over all chunks
+
+    // Compress the voxels of every chunk that was not edited since the last call.
+    // Call once per frame; chunks being sculpted stay uncompressed.
+    void compressIdleChunks();
+
+    // Helper to generate voxel data, now accepts the base ISDFEdit vector.
+    // Terrain is a heightfield: one noise sample per column, then every 64-voxel
+    // row is written as runs of its solid bits (no per-voxel height test).
+    // The heightmap of a footprint is cached, so chunks above and below reuse it.
+    // If opaqueMask is given (CS_P2 column masks) it is filled in the same sweep,
+    // so the result can go straight to generateMeshData(voxels, opaqueMask).
+    // That saves the separate mask scan of the volume, which only shows on edit-free
+    // terrain: with edits, evaluating their SDFs dominates. Face culling stays in mesh().
     void generateVoxelsWithSDF(
         std::vector<uint8_t>& voxels,
         int cs_p_val,
@@ -227,7 +177,8 @@ public:
         int cs_p3_val,
         glm::ivec3 chunkOffsetInVoxels,
         FastNoiseLite& noise,
-        const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits // Changed to base class pointer
+        const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits, // Changed to base class pointer
+        uint64_t* opaqueMask = nullptr
     );
 
 
@@ -235,17 +186,33 @@ public:
     bool addSDFEditAtWorldPos(const ISDFEdit& edit, int chunkSizeInVoxels, FastNoiseLite& noise);
 
 
-    bool addSDFEditToChunk(glm::ivec3 chunkCoords, std::unique_ptr<ISDFEdit> edit,
+    // Add SDF modification to a specific chunk and remesh it.
+    // Only the chunk's voxels inside the edit bounds are rewritten.
+    // Its border is taken from the resident neighbors as they are now, so edits
+    // that cross chunk borders should go through addSDFEditAtWorldPos.
+    bool addSDFEditToChunk(glm::ivec3 chunkCoords, const ISDFEdit& edit,
         int chunkSizeInVoxels, FastNoiseLite& noise);
-    // NEW: Add SDF modification to a specific chunk and regenerate its mesh
-    
+
+    // Padded local voxel range [lo, hi] an edit can write in a chunk; false if it misses the chunk
+    static bool editLocalBounds(glm::ivec3 chunkOffsetInVoxels, const ISDFEdit& edit,
+        glm::ivec3& lo, glm::ivec3& hi);
+
+    // Write one edit into a padded chunk volume, limited to the edit's bounds.
+    // If opaqueMask is given (CS_P2 column masks) the touched bits are updated too.
+    static void applySDFEdit(
+        std::vector<uint8_t>& voxels,
+        uint64_t* opaqueMask,
+        glm::ivec3 chunkOffsetInVoxels,
+        const ISDFEdit& edit
+    );
+
 
     // NEW: Add SDF modification based on world position, converting to a single chunk
     /*bool addSDFSphereEditAtWorldPos(glm::vec3 worldPos, float radius, uint8_t material,
         int chunkSizeInVoxels, FastNoiseLite& noise);*/
 
     // Helper to generate mesh data from voxels, now accepts the base ISDFEdit vector
-    MeshData generateVoxelMesh(
+    const MeshData& generateVoxelMesh(
         int option,
         glm::ivec3 chunkOffsetInVoxels,
         FastNoiseLite& noise,
@@ -254,46 +221,90 @@ public:
 
     void profileOpaqueMaskGeneration(
         const std::vector<uint8_t>& voxels,
-        int CS_P,
-        int CS_P2,
         MeshData& meshData
     );
 
-    MeshData generateMeshData(const std::vector<uint8_t>& voxels);
-
-private:
-    bool prepareChunkMesh(const glm::ivec3& coords);
-    void prepareMetadataBuffer();
-
-    UniversalPool<uint64_t, true>* pool = nullptr;
-    ChunkBufferManager bufferMgr;
-    GLuint metadataSSBO = 0;
-
-    std::unordered_map<glm::ivec3, ChunkMetadata, IVec3Hash, IVec3Eq> chunkMap;
-    std::vector<ChunkData> tempChunkData;
-};
-
+    // Meshes into the calling thread's MeshWorkspace (no allocation in steady state).
+    // Quads are (*vertices)[0, vertexCount); valid until this thread meshes again.
+    const MeshData& generateMeshData(const std::vector<uint8_t>& voxels);
 
+    // Same, but meshes against masks the caller keeps in sync with the voxels
+    // (ChunkVoxels::opaqueMask()) instead of rebuilding them. With dirtyLayers
+    // only those layers are remeshed (see mesh() and ChunkMesh::splice).
+    const MeshData& generateMeshData(const std::vector<uint8_t>& voxels, const uint64_t* opaqueMask,
+        const uint64_t* dirtyLayers = nullptr);
 
+private:
+    // Heightmap of the chunk footprint at chunkOffsetInVoxels, from heightmapCache or freshly sampled
+    std::shared_ptr<const HeightmapTile> acquireHeightmap(glm::ivec3 chunkOffsetInVoxels, FastNoiseLite& noise);
 
-#endif // CHUNK_HANDLER_H
-
+    // Worker-safe parts of an edit, run as two passes over all affected chunks:
+    // 1) materialize and apply (writes only md), 2) pull neighbor borders and
+    // remesh (writes only md's padding, reads neighbors' interiors).
+    void applyEditToChunk(ChunkMetadata& md, const ISDFEdit& edit,
+        int chunkSizeInVoxels, FastNoiseLite& noise);
+    void remeshEditedChunk(ChunkMetadata& md, const ISDFEdit& edit,
+        int chunkSizeInVoxels, std::vector<uint64_t>& quadsOut);
 
+    // After generateChunk stored a chunk: pull the new border into the padding of each
+    // resident face neighbor one of sdfEdits reaches, and remesh those neighbors
+    bool remeshNeighborsOfEdits(const glm::ivec3& coords,
+        const std::vector<std::unique_ptr<ISDFEdit>>& sdfEdits);
 
+    // Overwrite the padding planes of a volume with the facing interior planes of
+    // the resident neighbors (chunks without a neighbor keep their own border).
+    // Keeps opaqueMask in sync and flags changed border layers in dirtyLayers; both may be null.
+    void assembleNeighborBorders(glm::ivec3 coords, std::vector<uint8_t>& voxels,
+        uint64_t* opaqueMask, uint64_t* dirtyLayers) const;
 
-/*
-Measure once, batch updates.
-Instead of mapping / unmapping your SSBO per - chunk, accumulate all modified quad arrays in a single contiguous upload and do one glMapBufferRange(or glBufferSubData) call.
+    // Enlarge pool and backend buffer so that neededQuads more fit; false at the limit
+    bool growQuadHeap(uint32_t neededQuads);
 
-Avoid full‐volume regen when editing a small sphere.
-Right now generateVoxelsWithSDF always loops over all 64³ voxels.Instead, only update voxels inside the sphere’s bounding box(and its immediate neighbors), then incrementally remesh just that sub‐region.
+    // Point the chunk at its new pool range and retire the old one
+    void commitChunkQuads(ChunkMetadata& md, int nodeID);
 
-Reuse your voxel and vertex buffers.
+    // Free a pool range once the GPU can no longer be reading it (right away when headless)
+    void retireAllocation(int poolNodeID);
+    void releaseRetiredAllocations();
 
-Keep a single, preallocated std::vector<uint8_t> voxels(64 * 64 * 64) and just fill() instead of reallocating each time.
+    // Quad vectors handed back by addOrUpdateChunk/flushUploads, reused for the next
+    // meshes so their capacity is only grown once
+    std::vector<uint64_t> takeQuadBuffer();
+    void recycleQuadBuffer(std::vector<uint64_t>&& quads);
 
-Reserve capacity on your BM_VECTOR<uint64_t> so it never needs to new[] or shrink_to_fit() on every mesh.
+    UniversalPool<uint64_t, true>* pool = nullptr;
+    uint32_t quadCapacityLimit = 1u << 28; // 2 GiB of quads
+    IChunkRenderBackend* backend = nullptr; // not owned
+    std::unique_ptr<JobSystem> jobs;
+
+    FlatChunkMap<ChunkMetadata> chunkMap; // dense: values() is every loaded chunk
+    ChunkDrawTable drawTable;
+    HeightmapCache heightmapCache;
+    std::vector<ChunkDataRange> dirtyMetadata; // scratch for bindMetadataSSBO
+    size_t metadataBytesUploaded = 0;
+
+    struct RetiredAllocation {
+        int poolNodeID;
+        uint64_t frame; // last frame that may have drawn it
+    };
+    std::vector<RetiredAllocation> retiredAllocations; // in frame order
+    uint64_t frameIndex = 0;
+
+    struct PendingUpload {
+        glm::ivec3 coords;
+        uint32_t serial;  // stale unless it matches the chunk's pendingUpload
+        int poolNodeID;   // allocated when queued, -1 for an empty mesh
+        std::vector<uint64_t> quads;
+    };
+    std::deque<PendingUpload> pendingUploads; // oldest first
+    std::vector<ChunkQuadUpload> uploadBatch; // scratch for flushUploads
+    std::vector<std::vector<uint64_t>> spareQuadBuffers; // see takeQuadBuffer
+    static constexpr size_t maxSpareQuadBuffers = 64;
+    std::vector<ChunkMetadata*> compactionCandidates; // scratch for compactQuadHeap
+    float compactionThreshold = 0.25f;
+    uint32_t uploadSerial = 0;
+    size_t uploadBudget = 8u << 20; // bytes per flushUploads, fits one staging region
+    size_t lastUploadBytes = 0;
+};
 
-Cut down on unordered_map overhead.
-If you’re frequently doing chunkMap.find() + erase / insert, consider a flat hash or even a 3D array / hash - grid for small worlds.That can shave tens of microseconds per lookup.
-*/
\ No newline at end of file
+#endif // CHUNK_HANDLER_H
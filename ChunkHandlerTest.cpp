@@ -0,0 +1,83 @@
+// ChunkHandlerTest.cpp
+//
+// Headless regression checks for ChunkHandler. Each check builds chunks in a
+// handler with a CPU quad shadow and compares the quads a chunk draws against
+// a fresh handler that reached the same voxels by the shortest route.
+// Prints one line per check and exits non-zero if any failed (run by ctest).
+//
+// Usage: ChunkHandlerTest
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ChunkHandler.h"
+
+namespace {
+
+// Quad order differs between a spliced ChunkMesh and a full mesh, the set must not
+std::vector<uint64_t> sortedQuads(const ChunkHandler& handler, glm::ivec3 coords) {
+    std::vector<uint64_t> quads;
+    handler.readChunkQuads(coords, quads);
+    std::sort(quads.begin(), quads.end());
+    return quads;
+}
+
+// Small sphere around a chunk-local voxel position
+SDFSphereEdit brushAt(glm::ivec3 coords, glm::ivec3 localVoxel, uint8_t material) {
+    const glm::vec3 voxel = glm::vec3(coords * CS + localVoxel);
+    return SDFSphereEdit(voxel * ChunkHandler::voxel_scale, 0.5f, material);
+}
+
+std::vector<std::unique_ptr<ISDFEdit>> editList(const SDFSphereEdit& edit) {
+    std::vector<std::unique_ptr<ISDFEdit>> edits;
+    edits.push_back(std::make_unique<SDFSphereEdit>(edit));
+    return edits;
+}
+
+// Edit -> regenerate -> edit: the second edit must splice into the regenerated
+// chunk's mesh, not into the per-layer mesh kept from before the regeneration.
+bool checkRegenerateAfterEdit(const char* label, glm::ivec3 coords,
+    const std::function<void(ChunkHandler&)>& regenerate) {
+    // Opposite corners, so the layers the second edit remeshes miss the first one
+    const SDFSphereEdit first = brushAt(coords, glm::ivec3(12), 0);
+    const SDFSphereEdit second = brushAt(coords, glm::ivec3(48), 0);
+
+    ChunkHandler handler;
+    handler.init(1u << 16, nullptr, 2, true);
+    regenerate(handler);
+    handler.addSDFEditToChunk(coords, first, CS, ChunkHandler::sharedNoise);
+    regenerate(handler);
+    handler.addSDFEditToChunk(coords, second, CS, ChunkHandler::sharedNoise);
+
+    ChunkHandler reference;
+    reference.init(1u << 16, nullptr, 2, true);
+    regenerate(reference);
+    reference.addSDFEditToChunk(coords, second, CS, ChunkHandler::sharedNoise);
+
+    const std::vector<uint64_t> quads = sortedQuads(handler, coords);
+    const bool ok = !quads.empty() && quads == sortedQuads(reference, coords);
+    std::cout << (ok ? "ok     " : "FAILED ") << label << "\n";
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    // Buried chunk (classified Solid), so both carves are visible
+    const glm::ivec3 buried(2, -4, 2);
+    const SDFSphereEdit centerCarve = brushAt(buried, glm::ivec3(31), 0);
+
+    int failed = 0;
+    failed += !checkRegenerateAfterEdit("regenerate uniform chunk after edit", buried,
+        [&](ChunkHandler& h) { h.generateChunk(buried); });
+    failed += !checkRegenerateAfterEdit("regenerate chunk with edits after edit", buried,
+        [&](ChunkHandler& h) { h.generateChunk(buried, editList(centerCarve)); });
+    failed += !checkRegenerateAfterEdit("regenerate chunk batch after edit", buried,
+        [&](ChunkHandler& h) { h.generateChunks({ buried }); });
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
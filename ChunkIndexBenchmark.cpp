@@ -0,0 +1,163 @@
+// ChunkIndexBenchmark.cpp
+//
+// Compares the chunk index used by ChunkHandler (FlatChunkMap) with the
+// std::unordered_map + IVec3Hash it replaced: insert, lookup (hits and misses),
+// a full iteration over every chunk, and erase.
+// Values are real ChunkMetadata so entry size matches the engine.
+//
+// Usage: ChunkIndexBenchmark [chunkCount]   (default 100000)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "ChunkHandler.h"
+#include "FlatChunkMap.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// The ivec3 hash the unordered_map chunk index used
+struct IVec3Hash {
+    size_t operator()(glm::ivec3 const& v) const noexcept {
+        uint64_t x = static_cast<uint64_t>(v.x);
+        uint64_t y = static_cast<uint64_t>(v.y);
+        uint64_t z = static_cast<uint64_t>(v.z);
+        uint64_t h = (x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u);
+        return static_cast<size_t>(h);
+    }
+};
+struct IVec3Eq {
+    bool operator()(glm::ivec3 const& a, glm::ivec3 const& b) const noexcept {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+};
+
+double elapsedNs(clock_type::time_point t0) {
+    return std::chrono::duration<double, std::nano>(clock_type::now() - t0).count();
+}
+
+struct Timings {
+    double insertNs = 0, hitNs = 0, missNs = 0, iterateNs = 0, eraseNs = 0;
+    uint64_t checksum = 0; // keeps the loops from being optimized out
+};
+
+ChunkMetadata makeChunk(const glm::ivec3& c, int i) {
+    ChunkMetadata md;
+    md.chunkCoords = c;
+    md.poolNodeID = i;
+    md.quadCount = static_cast<uint32_t>(i & 1023);
+    md.ssboSlotOffset = static_cast<uint32_t>(i) * 64;
+    return md;
+}
+
+Timings runUnordered(const std::vector<glm::ivec3>& coords, const std::vector<glm::ivec3>& misses) {
+    Timings t;
+    std::unordered_map<glm::ivec3, ChunkMetadata, IVec3Hash, IVec3Eq> map;
+
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < coords.size(); ++i) map[coords[i]] = makeChunk(coords[i], static_cast<int>(i));
+    t.insertNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (const glm::ivec3& c : coords) t.checksum += map.find(c)->second.quadCount;
+    t.hitNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (const glm::ivec3& c : misses) t.checksum += map.find(c) == map.end();
+    t.missNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (auto& kv : map) t.checksum += kv.second.ssboSlotOffset + kv.second.quadCount;
+    t.iterateNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (size_t i = 0; i < coords.size(); i += 2) map.erase(coords[i]);
+    t.eraseNs = elapsedNs(t0);
+    t.checksum += map.size();
+    return t;
+}
+
+Timings runFlat(const std::vector<glm::ivec3>& coords, const std::vector<glm::ivec3>& misses) {
+    Timings t;
+    FlatChunkMap<ChunkMetadata> map;
+
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < coords.size(); ++i) map.insertOrAssign(coords[i], makeChunk(coords[i], static_cast<int>(i)));
+    t.insertNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (const glm::ivec3& c : coords) t.checksum += map.find(c)->quadCount;
+    t.hitNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (const glm::ivec3& c : misses) t.checksum += map.find(c) == nullptr;
+    t.missNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (const ChunkMetadata& md : map.values()) t.checksum += md.ssboSlotOffset + md.quadCount;
+    t.iterateNs = elapsedNs(t0);
+
+    t0 = clock_type::now();
+    for (size_t i = 0; i < coords.size(); i += 2) map.erase(coords[i]);
+    t.eraseNs = elapsedNs(t0);
+    t.checksum += map.size();
+    return t;
+}
+
+void printRow(const char* name, const Timings& t, size_t n) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(12) << t.insertNs / n
+        << std::setw(12) << t.hitNs / n
+        << std::setw(12) << t.missNs / n
+        << std::setw(12) << t.iterateNs / n
+        << std::setw(12) << t.eraseNs / (n / 2) << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int chunkCount = 100000;
+    if (argc > 1) chunkCount = std::max(1, std::atoi(argv[1]));
+
+    // A world-like volume of chunks (wide in x/z, shallow in y), inserted in random order
+    std::vector<glm::ivec3> coords;
+    const int side = static_cast<int>(std::ceil(std::sqrt(chunkCount / 8.0)));
+    for (int y = -4; y < 4 && static_cast<int>(coords.size()) < chunkCount; ++y)
+        for (int x = -side / 2; x < side - side / 2 && static_cast<int>(coords.size()) < chunkCount; ++x)
+            for (int z = -side / 2; z < side - side / 2 && static_cast<int>(coords.size()) < chunkCount; ++z)
+                coords.emplace_back(x, y, z);
+    std::mt19937 rng(42);
+    std::shuffle(coords.begin(), coords.end(), rng);
+
+    std::vector<glm::ivec3> misses;
+    for (const glm::ivec3& c : coords) misses.emplace_back(c.x, c.y + 64, c.z);
+
+    const size_t n = coords.size();
+    Timings unorderedT = runUnordered(coords, misses);
+    Timings flatT = runFlat(coords, misses);
+
+    std::cout << n << " chunks, ns per operation\n";
+    std::cout << std::left << std::setw(16) << "index" << std::right
+        << std::setw(12) << "insert"
+        << std::setw(12) << "lookup"
+        << std::setw(12) << "miss"
+        << std::setw(12) << "iterate"
+        << std::setw(12) << "erase" << "\n";
+    printRow("unordered_map", unorderedT, n);
+    printRow("FlatChunkMap", flatT, n);
+
+    if (unorderedT.checksum != flatT.checksum) {
+        std::cerr << "checksum mismatch: " << unorderedT.checksum << " vs " << flatT.checksum << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+
+#include "ChunkMesh.h"
+#include <algorithm> // for std::max, std::min
+
+int ChunkMesh::quadLayer(uint64_t quad) {
+    // mesh() puts the face plane at layer + 1 for faces 0, 2 and 4, at layer for 1, 3 and 5
+    const int face = quadFace(quad);
+    int plane;
+    switch (face / 2) {
+    case 0:  plane = static_cast<int>((quad >> 6) & 0x3F); break;  // y
+    case 1:  plane = static_cast<int>(quad & 0x3F); break;         // x
+    default: plane = static_cast<int>((quad >> 12) & 0x3F); break; // z
+    }
+    return plane - ((face & 1) ? 0 : 1);
+}
+
+void ChunkMesh::dirtyLayersForBox(int loX, int loY, int loZ, int hiX, int hiY, int hiZ, uint64_t out[6]) {
+    // Padded coordinate p is interior layer p - 1; a layer also reads its neighbors along the normal
+    auto range = [](int lo, int hi) -> uint64_t {
+        lo = std::max(lo - 2, 0);
+        hi = std::min(hi, CS - 1);
+        if (lo > hi) return 0;
+        return ((1ull << (hi + 1)) - 1) & ~((1ull << lo) - 1);
+    };
+    out[0] = out[1] = range(loY, hiY);
+    out[2] = out[3] = range(loX, hiX);
+    out[4] = out[5] = range(loZ, hiZ);
+}
+
+void ChunkMesh::bucket(const uint64_t* quads, size_t count, std::vector<uint32_t>& begin, std::vector<uint64_t>& out) {
+    // Counting sort by face * CS + layer; keeps mesh() order inside a layer
+    begin.assign(LAYER_COUNT + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        begin[quadFace(quads[i]) * CS + quadLayer(quads[i]) + 1]++;
+    }
+    for (int b = 0; b < LAYER_COUNT; ++b) begin[b + 1] += begin[b];
+
+    out.resize(count);
+    fillCursor.assign(begin.begin(), begin.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        out[fillCursor[quadFace(quads[i]) * CS + quadLayer(quads[i])]++] = quads[i];
+    }
+}
+
+void ChunkMesh::assign(const uint64_t* quads, size_t count) {
+    bucket(quads, count, layerBegin, quads_);
+}
+
+void ChunkMesh::splice(const uint64_t dirtyLayers[6], const uint64_t* quads, size_t count) {
+    if (empty()) {
+        assign(quads, count);
+        return;
+    }
+    bucket(quads, count, spliceBegin, spliceQuads);
+
+    mergedQuads.clear();
+    mergedQuads.reserve(quads_.size() + count);
+    uint32_t written = 0;
+    for (int b = 0; b < LAYER_COUNT; ++b) {
+        const bool dirty = (dirtyLayers[b / CS] >> (b % CS)) & 1;
+        const std::vector<uint64_t>& src = dirty ? spliceQuads : quads_;
+        const std::vector<uint32_t>& begin = dirty ? spliceBegin : layerBegin;
+        mergedQuads.insert(mergedQuads.end(), src.begin() + begin[b], src.begin() + begin[b + 1]);
+
+        layerBegin[b] = written; // safe: entry b is not read again
+        written = static_cast<uint32_t>(mergedQuads.size());
+    }
+    layerBegin[LAYER_COUNT] = written;
+    quads_.swap(mergedQuads);
+}
+
+void ChunkMesh::clear() {
+    quads_.clear(); quads_.shrink_to_fit();
+    layerBegin.clear(); layerBegin.shrink_to_fit();
+    spliceQuads.clear(); spliceQuads.shrink_to_fit();
+    spliceBegin.clear(); spliceBegin.shrink_to_fit();
+    mergedQuads.clear(); mergedQuads.shrink_to_fit();
+    fillCursor.clear(); fillCursor.shrink_to_fit();
+}
+
+size_t ChunkMesh::memoryUsage() const {
+    return (quads_.capacity() + spliceQuads.capacity() + mergedQuads.capacity()) * sizeof(uint64_t)
+        + (layerBegin.capacity() + spliceBegin.capacity() + fillCursor.capacity()) * sizeof(uint32_t);
+}
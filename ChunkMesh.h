@@ -0,0 +1,56 @@
+#pragma once
+#ifndef CHUNK_MESH_H
+#define CHUNK_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mesher.h" // CS
+
+// ----------------------------------------------------------------------------
+// ChunkMesh
+//
+// CPU copy of a chunk's quads grouped by face, then by layer along the face
+// normal (the same layers mesh() takes in dirtyLayers). A small edit only
+// remeshes the layers it touched and splices them in; untouched layers keep
+// their quads. Kept for hot chunks only.
+// ----------------------------------------------------------------------------
+class ChunkMesh {
+public:
+    static constexpr int LAYER_COUNT = 6 * CS;
+
+    bool empty() const { return layerBegin.empty(); }
+
+    // Replace everything with a full mesh() result
+    void assign(const uint64_t* quads, size_t count);
+
+    // Replace the layers set in dirtyLayers[face] with quads from mesh(voxels, meshData, dirtyLayers)
+    void splice(const uint64_t dirtyLayers[6], const uint64_t* quads, size_t count);
+
+    const std::vector<uint64_t>& quads() const { return quads_; }
+
+    void clear();
+    size_t memoryUsage() const;
+
+    // Layers a voxel change inside the padded box [lo, hi] can affect: quads of a layer
+    // depend on its own voxels and the ones just outside it along the normal.
+    static void dirtyLayersForBox(int loX, int loY, int loZ, int hiX, int hiY, int hiZ, uint64_t out[6]);
+
+    // Face (0-5) and layer (0..CS-1) a quad was emitted for, decoded from its packing
+    static int quadFace(uint64_t quad) { return static_cast<int>((quad >> 40) & 0x7); }
+    static int quadLayer(uint64_t quad);
+
+private:
+    void bucket(const uint64_t* quads, size_t count, std::vector<uint32_t>& begin, std::vector<uint64_t>& out);
+
+    std::vector<uint64_t> quads_;      // grouped by face * CS + layer
+    std::vector<uint32_t> layerBegin;  // LAYER_COUNT + 1 offsets into quads_
+
+    // splice scratch, kept to avoid reallocating every edit
+    std::vector<uint64_t> spliceQuads;
+    std::vector<uint32_t> spliceBegin;
+    std::vector<uint64_t> mergedQuads;
+    std::vector<uint32_t> fillCursor;
+};
+
+#endif // CHUNK_MESH_H
@@ -0,0 +1,94 @@
+#pragma once
+#ifndef CHUNK_RENDER_BACKEND_H
+#define CHUNK_RENDER_BACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext/vector_int4.hpp>
+
+// ----------------------------------------------------------------------------
+// Struct for GPU-side per-chunk metadata
+// Must match this layout exactly in GLSL:
+//
+// struct ChunkData {
+//     ivec3 offset; // chunk coordinates
+//     int   first;  // first vertex index in draw
+//     int   count;  // vertex count for draw
+// };
+//
+// layout(std430, binding = 2) buffer ChunkInfo {
+//     uint       chunkCount;
+//     ChunkData  data[];
+// };
+// ----------------------------------------------------------------------------
+struct ChunkData {
+    glm::ivec4 offset;  // Change to glm::ivec4 to match GLSL's 16-byte alignment
+    int        first;
+    int        count;
+    int        padding1; // Add padding to make struct 32 bytes
+    int        padding2; // Add padding to make struct 32 bytes
+};
+
+// One chunk's quads for IChunkRenderBackend::uploadChunkQuads
+struct ChunkQuadUpload {
+    uint64_t        chunkKey;
+    const uint64_t* quads;
+    uint32_t        quadCount;
+    uint32_t        slotOffset; // first slot in the quad buffer (one slot = one uint64_t quad)
+};
+
+// Half-open range [begin, end) of ChunkData entries that changed since the last upload
+struct ChunkDataRange {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// ----------------------------------------------------------------------------
+// Render backend interface
+//
+// ChunkHandler only does CPU-side bookkeeping (generation, meshing, pool
+// offsets). Everything that touches the graphics API goes through this
+// interface, so the core builds and runs without a GL context. A null
+// backend means headless: meshes are produced and tracked but never uploaded.
+// ----------------------------------------------------------------------------
+class IChunkRenderBackend {
+public:
+    // Create GPU storage for maxTotalQuads packed quads (the starting size) and the metadata buffer.
+    // Must be called after graphics context creation.
+    virtual bool initialize(uint32_t maxTotalQuads) = 0;
+    virtual void destroy() = 0;
+
+    // Enlarge the quad buffer to maxTotalQuads, keeping every quad at its slot
+    virtual bool growQuadCapacity(uint32_t maxTotalQuads) = 0;
+
+    // Copy a batch of chunks' quads into the quad buffer, each at its slotOffset.
+    // ChunkHandler hands over everything it uploads in a frame in one call.
+    virtual void uploadChunkQuads(const ChunkQuadUpload* uploads, size_t count) = 0;
+
+    // Copy quadCount quads inside the quad buffer from srcSlot to dstSlot (ranges never overlap)
+    virtual void copyChunkQuads(uint32_t srcSlot, uint32_t dstSlot, uint32_t quadCount) = 0;
+
+    // Bring the per-chunk metadata array read by the vertex shader up to date.
+    // data holds all count entries (entry i = gl_DrawID i); only the entries in
+    // dirty and, if it changed, chunkCount have to be written. Returns bytes written.
+    virtual size_t updateChunkMetadata(const ChunkData* data, uint32_t count,
+        const std::vector<ChunkDataRange>& dirty) = 0;
+
+    // Bind the quad / metadata buffers to shader binding points
+    virtual void bindQuads(uint32_t bindingPoint) const = 0;
+    virtual void bindMetadata(uint32_t bindingPoint) const = 0;
+
+    // Forget all staged chunk data (called from ChunkHandler::clearAll)
+    virtual void clear() = 0;
+
+    // Mark the end of frame 'frame' (0, 1, 2, ...) in the GPU command stream.
+    virtual void fenceFrame(uint64_t frame) = 0;
+    // Number of frames the GPU has fully finished, i.e. frames [0, n) are done
+    // and quad ranges last drawn in them may be overwritten.
+    virtual uint64_t completedFrames() = 0;
+
+    virtual ~IChunkRenderBackend() = default;
+};
+
+#endif // CHUNK_RENDER_BACKEND_H
@@ -0,0 +1,270 @@
+
+#include "ChunkVoxels.h"
+#include <algorithm> // for std::sort
+#include <cstring>   // for std::memset, std::memcpy
+
+namespace {
+
+// expand[b] has byte i set to 0xFF when bit i of b is set
+struct BitExpandTable {
+    uint64_t expand[256];
+    BitExpandTable() {
+        for (int b = 0; b < 256; ++b) {
+            uint64_t m = 0;
+            for (int i = 0; i < 8; ++i) if (b >> i & 1) m |= 0xFFull << (i * 8);
+            expand[b] = m;
+        }
+    }
+};
+
+const BitExpandTable& bitExpandTable() {
+    static const BitExpandTable table; // thread-safe init
+    return table;
+}
+
+// A packed word whose every index is 1, for the given index width
+inline uint64_t allOnesIndexWord(int bits) {
+    switch (bits) {
+    case 1: return ~0ull;
+    case 2: return 0x5555555555555555ull;
+    case 4: return 0x1111111111111111ull;
+    default: return 0x0101010101010101ull;
+    }
+}
+
+inline bool testBit(const std::vector<uint64_t>& bitmap, size_t i) {
+    return (bitmap[i >> 6] >> (i & 63)) & 1;
+}
+
+inline int popcount64(uint64_t v) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(v));
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+} // namespace
+
+void ChunkVoxels::assign(std::vector<uint8_t>&& padded) {
+    raw_ = std::move(padded);
+    raw_.resize(CS_P3, 0);
+    releaseCompressed();
+    hasData = true;
+    rebuildOpaqueMask();
+}
+
+void ChunkVoxels::assign(std::vector<uint8_t>&& padded, std::vector<uint64_t>&& opaqueMask) {
+    if (padded.size() != CS_P3 || opaqueMask.size() != CS_P2) {
+        assign(std::move(padded)); // not a full volume: masks can't be trusted
+        return;
+    }
+    raw_ = std::move(padded);
+    opaque_ = std::move(opaqueMask);
+    releaseCompressed();
+    hasData = true;
+}
+
+std::vector<uint8_t>& ChunkVoxels::raw() {
+    if (raw_.empty()) {
+        raw_.resize(CS_P3);
+        decodeCompressed(raw_.data());
+        hasData = true;
+        releaseCompressed();
+        rebuildOpaqueMask();
+    }
+    return raw_;
+}
+
+std::vector<uint64_t>& ChunkVoxels::opaqueMask() {
+    raw();
+    return opaque_;
+}
+
+void ChunkVoxels::rebuildOpaqueMask() {
+    opaque_.resize(CS_P2);
+    buildOpaqueMask(raw_.data(), opaque_.data());
+}
+
+void ChunkVoxels::decode(uint8_t* out) const {
+    if (!raw_.empty()) {
+        std::memcpy(out, raw_.data(), CS_P3);
+        return;
+    }
+    decodeCompressed(out);
+}
+
+void ChunkVoxels::readPlane(int axis, int index, uint8_t* out) const {
+    if (!raw_.empty()) {
+        for (int p = 0; p < CS_P2; ++p) out[p] = raw_[planeVoxelIndex(axis, index, p)];
+        return;
+    }
+    if (!hasData || bitsPerVoxel == 0) {
+        std::memset(out, uniformValue(), CS_P2);
+        return;
+    }
+
+    // Random access into packed needs the number of mixed words before each bitmap word
+    const int perWord = 64 / bitsPerVoxel;
+    const uint64_t mask = (1ull << bitsPerVoxel) - 1;
+    uint32_t rank[CS_P3 / 8 / 64]; // one per bitmap word at 8 bits per voxel, the widest case
+    uint32_t running = 0;
+    for (size_t i = 0; i < mixedWords.size(); ++i) {
+        rank[i] = running;
+        running += static_cast<uint32_t>(popcount64(mixedWords[i]));
+    }
+
+    size_t cachedWord = ~size_t(0);
+    uint64_t bits = 0;
+    for (int p = 0; p < CS_P2; ++p) {
+        const size_t v = planeVoxelIndex(axis, index, p);
+        const size_t w = v / perWord;
+        if (w != cachedWord) {
+            cachedWord = w;
+            const uint64_t below = mixedWords[w >> 6] & ((1ull << (w & 63)) - 1);
+            if (testBit(mixedWords, w)) bits = packed[rank[w >> 6] + popcount64(below)];
+            else bits = testBit(fillWords, w) ? allOnesIndexWord(bitsPerVoxel) : 0;
+        }
+        out[p] = palette[(bits >> ((v % perWord) * bitsPerVoxel)) & mask];
+    }
+}
+
+void ChunkVoxels::decodeCompressed(uint8_t* out) const {
+    if (!hasData || bitsPerVoxel == 0) {
+        std::memset(out, uniformValue(), CS_P3);
+        return;
+    }
+
+    const int perWord = 64 / bitsPerVoxel;
+    const size_t wordCount = static_cast<size_t>(CS_P3) / perWord;
+    size_t cursor = 0; // next entry in packed
+
+    if (bitsPerVoxel == 1) {
+        // One word = one 64-voxel row. Expand 8 bits at a time into 8 byte-masks
+        // and blend the two palette entries with them.
+        const uint64_t* expand = bitExpandTable().expand;
+        const uint64_t p0 = 0x0101010101010101ull * palette[0];
+        const uint64_t p1 = 0x0101010101010101ull * palette[1];
+        for (size_t w = 0; w < wordCount; ++w) {
+            uint8_t* row = out + w * 64;
+            if (!testBit(mixedWords, w)) {
+                std::memset(row, testBit(fillWords, w) ? palette[1] : palette[0], 64);
+                continue;
+            }
+            const uint64_t bits = packed[cursor++];
+            for (int i = 0; i < 8; ++i) {
+                const uint64_t m = expand[(bits >> (i * 8)) & 0xFF];
+                const uint64_t v = (p1 & m) | (p0 & ~m);
+                std::memcpy(row + i * 8, &v, sizeof(v));
+            }
+        }
+        return;
+    }
+
+    // 2, 4 or 8 bits: indices never cross word boundaries
+    const uint64_t mask = (1ull << bitsPerVoxel) - 1;
+    for (size_t w = 0; w < wordCount; ++w) {
+        uint8_t* dst = out + w * perWord;
+        if (!testBit(mixedWords, w)) {
+            std::memset(dst, testBit(fillWords, w) ? palette[1] : palette[0], perWord);
+            continue;
+        }
+        uint64_t bits = packed[cursor++];
+        for (int i = 0; i < perWord; ++i) {
+            dst[i] = palette[bits & mask];
+            bits >>= bitsPerVoxel;
+        }
+    }
+}
+
+void ChunkVoxels::assignCompressed(const uint8_t* padded) {
+    raw_.clear();
+    raw_.shrink_to_fit();
+    opaque_.clear();
+    opaque_.shrink_to_fit();
+    compressFrom(padded);
+    hasData = true;
+}
+
+void ChunkVoxels::assignUniform(uint8_t material) {
+    raw_.clear();
+    raw_.shrink_to_fit();
+    opaque_.clear();
+    opaque_.shrink_to_fit();
+    releaseCompressed();
+    palette.assign(1, material); // bitsPerVoxel 0: no indices
+    hasData = true;
+}
+
+void ChunkVoxels::compress() {
+    if (raw_.empty()) return;
+    compressFrom(raw_.data());
+    raw_.clear();
+    raw_.shrink_to_fit();
+    opaque_.clear(); // rebuilt from the voxels when the chunk turns hot again
+    opaque_.shrink_to_fit();
+}
+
+void ChunkVoxels::compressFrom(const uint8_t* volume) {
+    // Palette sorted by frequency, so the two most common materials get
+    // indices 0 and 1 and their solid runs can be stored as fill words.
+    uint32_t histogram[256] = {};
+    for (int i = 0; i < CS_P3; ++i) histogram[volume[i]]++;
+    palette.clear();
+    for (int v = 0; v < 256; ++v) if (histogram[v]) palette.push_back(static_cast<uint8_t>(v));
+    std::sort(palette.begin(), palette.end(),
+        [&](uint8_t a, uint8_t b) { return histogram[a] > histogram[b]; });
+    palette.shrink_to_fit();
+
+    uint8_t lookup[256] = {};
+    for (size_t i = 0; i < palette.size(); ++i) lookup[palette[i]] = static_cast<uint8_t>(i);
+
+    const size_t n = palette.size();
+    bitsPerVoxel = n <= 1 ? 0 : n <= 2 ? 1 : n <= 4 ? 2 : n <= 16 ? 4 : 8;
+
+    packed.clear();
+    mixedWords.clear();
+    fillWords.clear();
+    if (bitsPerVoxel != 0) {
+        const int perWord = 64 / bitsPerVoxel;
+        const size_t wordCount = static_cast<size_t>(CS_P3) / perWord;
+        const uint64_t onesWord = allOnesIndexWord(bitsPerVoxel);
+        mixedWords.assign((wordCount + 63) / 64, 0);
+        fillWords.assign((wordCount + 63) / 64, 0);
+
+        for (size_t w = 0; w < wordCount; ++w) {
+            const uint8_t* src = volume + w * perWord;
+            uint64_t bits = 0;
+            for (int i = perWord - 1; i >= 0; --i) {
+                bits = (bits << bitsPerVoxel) | lookup[src[i]];
+            }
+
+            if (bits == onesWord) fillWords[w >> 6] |= 1ull << (w & 63);
+            else if (bits != 0) {
+                mixedWords[w >> 6] |= 1ull << (w & 63);
+                packed.push_back(bits);
+            }
+        }
+    }
+    packed.shrink_to_fit();
+}
+
+void ChunkVoxels::clear() {
+    hasData = false;
+    raw_.clear(); raw_.shrink_to_fit();
+    opaque_.clear(); opaque_.shrink_to_fit();
+    releaseCompressed();
+}
+
+void ChunkVoxels::releaseCompressed() {
+    palette.clear(); palette.shrink_to_fit();
+    packed.clear(); packed.shrink_to_fit();
+    mixedWords.clear(); mixedWords.shrink_to_fit();
+    fillWords.clear(); fillWords.shrink_to_fit();
+    bitsPerVoxel = 0;
+}
+
+size_t ChunkVoxels::memoryUsage() const {
+    return raw_.capacity() + palette.capacity()
+        + (opaque_.capacity() + packed.capacity() + mixedWords.capacity() + fillWords.capacity()) * sizeof(uint64_t);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef CHUNK_VOXELS_H
+#define CHUNK_VOXELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mesher.h" // CS_P3
+
+// ----------------------------------------------------------------------------
+// ChunkVoxels
+//
+// Materialized voxel data of one chunk, kept resident so edits only have to
+// touch the voxels inside their bounds instead of regenerating the chunk.
+// Layout is the padded 64^3 ZXY volume that mesh() takes.
+//
+// Two states:
+// - hot:  uncompressed CS_P3 bytes, writable through raw(), plus the CS_P2
+//         opaque column masks mesh() reads (see buildOpaqueMask). The masks
+//         are built once when the chunk turns hot and then kept in sync by
+//         whoever writes voxels, so remeshing skips the 64^3 scan.
+// - idle: per-chunk material palette + bit-packed palette indices (compress()).
+//         1, 2, 4 or 8 bits per voxel depending on the palette size, so an
+//         index never straddles two words. A chunk made of a single material
+//         (all air / all solid) stores no indices at all.
+//
+// The palette is sorted by frequency. Packed words that are entirely index 0
+// or entirely index 1 (fully buried / fully open rows) are only recorded in
+// two bitmaps; just the mixed words are stored. With 1 bit per voxel (air +
+// one material, the common terrain case) every word is one 64-voxel ZXY row,
+// so a surface chunk keeps little more than its surface rows.
+// ----------------------------------------------------------------------------
+class ChunkVoxels {
+public:
+    // True until a volume has been assigned
+    bool empty() const { return !hasData; }
+    bool isCompressed() const { return hasData && raw_.empty(); }
+
+    // Idle chunk made of one material (bitsPerVoxel == 0)
+    bool isUniform() const { return isCompressed() && bitsPerVoxel == 0; }
+    uint8_t uniformValue() const { return palette.empty() ? 0 : palette[0]; }
+
+    // Take ownership of a full padded volume (CS_P3 bytes). The chunk stays hot.
+    void assign(std::vector<uint8_t>&& padded);
+    // Same, with masks that already match the volume (e.g. from generation), so none are rebuilt
+    void assign(std::vector<uint8_t>&& padded, std::vector<uint64_t>&& opaqueMask);
+
+    // Idle chunk made of one material, without building a volume
+    void assignUniform(uint8_t material);
+
+    // Store a padded volume (CS_P3 bytes) straight in the idle representation.
+    // The caller keeps the buffer, so generation scratch can be reused.
+    void assignCompressed(const uint8_t* padded);
+
+    // Uncompressed, writable volume. Decompresses idle data first.
+    // Writers must update opaqueMask() for every voxel that changes between
+    // air and solid (applySDFEdit does), or call rebuildOpaqueMask() afterwards.
+    std::vector<uint8_t>& raw();
+
+    // Opaque column masks of the hot volume (CS_P2 entries). Makes the chunk hot.
+    std::vector<uint64_t>& opaqueMask();
+    void rebuildOpaqueMask();
+
+    // Bulk decode into out[CS_P3] without changing state
+    void decode(uint8_t* out) const;
+
+    // Copy one CS_P x CS_P plane (axis 0 = x, 1 = y, 2 = z, at padded index) into
+    // out[CS_P2], ordered by planeVoxelIndex(). Reads idle data in place, no decode.
+    void readPlane(int axis, int index, uint8_t* out) const;
+
+    // Volume index of entry p (0..CS_P2-1) of a plane, in ascending volume order
+    static size_t planeVoxelIndex(int axis, int index, int p) {
+        switch (axis) {
+        case 0:  return static_cast<size_t>((p & (CS_P - 1)) + index * CS_P + (p / CS_P) * CS_P2);
+        case 1:  return static_cast<size_t>(p + index * CS_P2);
+        default: return static_cast<size_t>(index + (p & (CS_P - 1)) * CS_P + (p / CS_P) * CS_P2);
+        }
+    }
+
+    // Drop to the idle representation (no-op if already idle or empty)
+    void compress();
+
+    void clear();
+
+    // Heap bytes held by this chunk's voxel data
+    size_t memoryUsage() const;
+
+private:
+    void decodeCompressed(uint8_t* out) const;
+    void compressFrom(const uint8_t* volume);
+    void releaseCompressed();
+
+    bool hasData = false;
+    std::vector<uint8_t> raw_;       // hot: CS_P3 voxels
+    std::vector<uint64_t> opaque_;   // hot: CS_P2 column masks of raw_
+    std::vector<uint8_t> palette;    // idle: palette index -> material
+    std::vector<uint64_t> packed;    // idle: mixed words only, bitsPerVoxel per index, LSB first
+    std::vector<uint64_t> mixedWords; // idle: bit w set = word w is the next entry of packed
+    std::vector<uint64_t> fillWords;  // idle: for other words, bit w set = all index 1, else all index 0
+    uint8_t bitsPerVoxel = 0;        // idle: 0 (uniform), 1, 2, 4 or 8
+};
+
+#endif // CHUNK_VOXELS_H
@@ -52,6 +52,22 @@
 
 #include <cmath>
 
+// GetNoiseGrid2D has AVX2 and SSE4.1 kernels on x86-64, picked at runtime
+#if defined(_M_X64) || defined(__x86_64__)
+#define FNL_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define FNL_TARGET_AVX2 __attribute__((target("avx2")))
+#define FNL_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define FNL_TARGET_AVX2
+#define FNL_TARGET_SSE41
+#endif
+#endif
+
 class FastNoiseLite
 {
 public:
@@ -339,6 +355,45 @@ public:
     }
 
 
+    /// <summary>
+    /// 2D noise over a uniform grid using current settings
+    /// </summary>
+    /// <remarks>
+    /// Fills out[j * xSize + i] with GetNoise((xStart + i) * step, (yStart + j) * step).
+    /// Grid points are integers scaled by step, so neighboring grids that overlap
+    /// sample exactly the same positions.
+    /// Perlin and OpenSimplex2 with no fractal or FBm run 8 points at a time when
+    /// the CPU has AVX2, 4 at a time when it has SSE4.1. The kernels repeat
+    /// GetNoise's operations in the same order (no FMA), so results match it bit
+    /// for bit. Everything else falls back to GetNoise per point.
+    /// </remarks>
+    void GetNoiseGrid2D(float* out, int xStart, int yStart, int xSize, int ySize, float step) const
+    {
+#ifdef FNL_X86_64
+        if (GridKernelsCover())
+        {
+            const int width = GridSimdWidth();
+            if (width == 8)
+            {
+                GenGrid2DAVX2(out, xStart, yStart, xSize, ySize, step);
+                return;
+            }
+            if (width == 4)
+            {
+                GenGrid2DSSE41(out, xStart, yStart, xSize, ySize, step);
+                return;
+            }
+        }
+#endif
+        for (int j = 0; j < ySize; j++)
+        {
+            for (int i = 0; i < xSize; i++)
+            {
+                out[j * xSize + i] = GetNoise((float)(xStart + i) * step, (float)(yStart + j) * step);
+            }
+        }
+    }
+
     /// <summary>
     /// 2D warps the input position using current domain warp settings
     /// </summary>
@@ -2442,6 +2497,408 @@ private:
         yr += vy * warpAmp;
         zr += vz * warpAmp;
     }
+
+#ifdef FNL_X86_64
+    // Batched grid evaluation (GetNoiseGrid2D), 8 lanes per AVX2 register or
+    // 4 per SSE4.1 register. Each kernel repeats its scalar counterpart operation
+    // for operation, so lanes round the same way GetNoise does.
+
+    static bool CpuHasAVX2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] >> 27) & 1;
+        const bool avx = (info[2] >> 28) & 1;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves the YMM registers
+        __cpuidex(info, 7, 0);
+        return (info[1] >> 5) & 1;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    static bool CpuHasSSE41()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] >> 19) & 1;
+#else
+        return __builtin_cpu_supports("sse4.1");
+#endif
+    }
+
+    // Lanes of the widest grid kernel the CPU runs: 8 (AVX2), 4 (SSE4.1) or 0
+    static int GridSimdWidth()
+    {
+        static const int width = CpuHasAVX2() ? 8 : CpuHasSSE41() ? 4 : 0; // CPU check runs once
+        return width;
+    }
+
+    // Settings the grid kernels implement
+    bool GridKernelsCover() const
+    {
+        if (mNoiseType != NoiseType_OpenSimplex2 && mNoiseType != NoiseType_Perlin) return false;
+        return mFractalType == FractalType_None || mFractalType == FractalType_FBm;
+    }
+
+    FNL_TARGET_AVX2
+    static __m256i FastFloorAVX2(__m256 f)
+    {
+        // (int)f, minus 1 where !(f >= 0), like FastFloor
+        __m256i truncated = _mm256_cvttps_epi32(f);
+        __m256 below = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_NGE_UQ);
+        return _mm256_add_epi32(truncated, _mm256_castps_si256(below));
+    }
+
+    FNL_TARGET_AVX2
+    static __m256 LerpAVX2(__m256 a, __m256 b, __m256 t)
+    {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    FNL_TARGET_AVX2
+    static __m256 GradCoordAVX2(__m256i seed, __m256i xPrimed, __m256i yPrimed, __m256 xd, __m256 yd)
+    {
+        __m256i hash = _mm256_xor_si256(_mm256_xor_si256(seed, xPrimed), yPrimed);
+        hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(0x27d4eb2d));
+        hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+        hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+        __m256 xg = _mm256_i32gather_ps(Lookup<float>::Gradients2D, hash, 4);
+        __m256 yg = _mm256_i32gather_ps(Lookup<float>::Gradients2D, _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4);
+
+        return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+    }
+
+    FNL_TARGET_AVX2
+    static __m256 SingleSimplexAVX2(__m256i seed, __m256 x, __m256 y)
+    {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float G2 = (3 - SQRT3) / 6;
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        __m256i i = FastFloorAVX2(x);
+        __m256i j = FastFloorAVX2(y);
+        __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+        __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(xi, yi), _mm256_set1_ps(G2));
+        __m256 x0 = _mm256_sub_ps(xi, t);
+        __m256 y0 = _mm256_sub_ps(yi, t);
+
+        i = _mm256_mullo_epi32(i, _mm256_set1_epi32(PrimeX));
+        j = _mm256_mullo_epi32(j, _mm256_set1_epi32(PrimeY));
+        const __m256i iNext = _mm256_add_epi32(i, _mm256_set1_epi32(PrimeX));
+        const __m256i jNext = _mm256_add_epi32(j, _mm256_set1_epi32(PrimeY));
+
+        __m256 a = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+        __m256 aa = _mm256_mul_ps(a, a);
+        __m256 n0 = _mm256_mul_ps(_mm256_mul_ps(aa, aa), GradCoordAVX2(seed, i, j, x0, y0));
+        n0 = _mm256_and_ps(n0, _mm256_cmp_ps(a, zero, _CMP_NLE_UQ));
+
+        const float cT = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+        const float cA = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+        __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(cT), t), _mm256_add_ps(_mm256_set1_ps(cA), a));
+        __m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(2 * (float)G2 - 1));
+        __m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(2 * (float)G2 - 1));
+        __m256 cc = _mm256_mul_ps(c, c);
+        __m256 n2 = _mm256_mul_ps(_mm256_mul_ps(cc, cc), GradCoordAVX2(seed, iNext, jNext, x2, y2));
+        n2 = _mm256_and_ps(n2, _mm256_cmp_ps(c, zero, _CMP_NLE_UQ));
+
+        // Middle corner: (i, j + 1) above the diagonal, (i + 1, j) below it
+        __m256 upper = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+        __m256 x1 = _mm256_add_ps(x0, _mm256_blendv_ps(_mm256_set1_ps((float)G2 - 1), _mm256_set1_ps((float)G2), upper));
+        __m256 y1 = _mm256_add_ps(y0, _mm256_blendv_ps(_mm256_set1_ps((float)G2), _mm256_set1_ps((float)G2 - 1), upper));
+        __m256i i1 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(iNext), _mm256_castsi256_ps(i), upper));
+        __m256i j1 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(j), _mm256_castsi256_ps(jNext), upper));
+        __m256 b = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+        __m256 bb = _mm256_mul_ps(b, b);
+        __m256 n1 = _mm256_mul_ps(_mm256_mul_ps(bb, bb), GradCoordAVX2(seed, i1, j1, x1, y1));
+        n1 = _mm256_and_ps(n1, _mm256_cmp_ps(b, zero, _CMP_NLE_UQ));
+
+        return _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), _mm256_set1_ps(99.83685446303647f));
+    }
+
+    FNL_TARGET_AVX2
+    static __m256 InterpQuinticAVX2(__m256 t)
+    {
+        __m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6)), _mm256_set1_ps(15));
+        inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    FNL_TARGET_AVX2
+    static __m256 SinglePerlinAVX2(__m256i seed, __m256 x, __m256 y)
+    {
+        __m256i x0 = FastFloorAVX2(x);
+        __m256i y0 = FastFloorAVX2(y);
+
+        __m256 xd0 = _mm256_sub_ps(x, _mm256_cvtepi32_ps(x0));
+        __m256 yd0 = _mm256_sub_ps(y, _mm256_cvtepi32_ps(y0));
+        __m256 xd1 = _mm256_sub_ps(xd0, _mm256_set1_ps(1));
+        __m256 yd1 = _mm256_sub_ps(yd0, _mm256_set1_ps(1));
+
+        __m256 xs = InterpQuinticAVX2(xd0);
+        __m256 ys = InterpQuinticAVX2(yd0);
+
+        x0 = _mm256_mullo_epi32(x0, _mm256_set1_epi32(PrimeX));
+        y0 = _mm256_mullo_epi32(y0, _mm256_set1_epi32(PrimeY));
+        __m256i x1 = _mm256_add_epi32(x0, _mm256_set1_epi32(PrimeX));
+        __m256i y1 = _mm256_add_epi32(y0, _mm256_set1_epi32(PrimeY));
+
+        __m256 xf0 = LerpAVX2(GradCoordAVX2(seed, x0, y0, xd0, yd0), GradCoordAVX2(seed, x1, y0, xd1, yd0), xs);
+        __m256 xf1 = LerpAVX2(GradCoordAVX2(seed, x0, y1, xd0, yd1), GradCoordAVX2(seed, x1, y1, xd1, yd1), xs);
+
+        return _mm256_mul_ps(LerpAVX2(xf0, xf1, ys), _mm256_set1_ps(1.4247691104677813f));
+    }
+
+    FNL_TARGET_AVX2
+    __m256 GenNoiseSingleAVX2(__m256i seed, __m256 x, __m256 y) const
+    {
+        return mNoiseType == NoiseType_Perlin ? SinglePerlinAVX2(seed, x, y) : SingleSimplexAVX2(seed, x, y);
+    }
+
+    FNL_TARGET_AVX2
+    void GenGrid2DAVX2(float* out, int xStart, int yStart, int xSize, int ySize, float step) const
+    {
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 frequency = _mm256_set1_ps(mFrequency);
+        const __m256 stepV = _mm256_set1_ps(step);
+        const bool skew = mNoiseType == NoiseType_OpenSimplex2;
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const __m256 F2 = _mm256_set1_ps(0.5f * (SQRT3 - 1));
+
+        const int vectorEnd = xSize - xSize % 8;
+        for (int j = 0; j < ySize; j++)
+        {
+            const __m256 yGrid = _mm256_set1_ps((float)(yStart + j) * step);
+            for (int i = 0; i < vectorEnd; i += 8)
+            {
+                __m256i xi = _mm256_add_epi32(_mm256_set1_epi32(xStart + i), laneOffsets);
+                __m256 x = _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(xi), stepV), frequency);
+                __m256 y = _mm256_mul_ps(yGrid, frequency);
+                if (skew)
+                {
+                    __m256 t = _mm256_mul_ps(_mm256_add_ps(x, y), F2);
+                    x = _mm256_add_ps(x, t);
+                    y = _mm256_add_ps(y, t);
+                }
+
+                __m256 noise;
+                if (mFractalType == FractalType_FBm)
+                {
+                    int seed = mSeed;
+                    noise = _mm256_setzero_ps();
+                    __m256 amp = _mm256_set1_ps(mFractalBounding);
+                    for (int octave = 0; octave < mOctaves; octave++)
+                    {
+                        __m256 single = GenNoiseSingleAVX2(_mm256_set1_epi32(seed++), x, y);
+                        noise = _mm256_add_ps(noise, _mm256_mul_ps(single, amp));
+                        __m256 weight = _mm256_mul_ps(_mm256_min_ps(_mm256_add_ps(single, _mm256_set1_ps(1)), _mm256_set1_ps(2)), _mm256_set1_ps(0.5f));
+                        amp = _mm256_mul_ps(amp, LerpAVX2(_mm256_set1_ps(1.0f), weight, _mm256_set1_ps(mWeightedStrength)));
+
+                        x = _mm256_mul_ps(x, _mm256_set1_ps(mLacunarity));
+                        y = _mm256_mul_ps(y, _mm256_set1_ps(mLacunarity));
+                        amp = _mm256_mul_ps(amp, _mm256_set1_ps(mGain));
+                    }
+                }
+                else
+                {
+                    noise = GenNoiseSingleAVX2(_mm256_set1_epi32(mSeed), x, y);
+                }
+                _mm256_storeu_ps(out + j * xSize + i, noise);
+            }
+            for (int i = vectorEnd; i < xSize; i++) // row tail
+            {
+                out[j * xSize + i] = GetNoise((float)(xStart + i) * step, (float)(yStart + j) * step);
+            }
+        }
+    }
+
+    FNL_TARGET_SSE41
+    static __m128i FastFloorSSE41(__m128 f)
+    {
+        __m128i truncated = _mm_cvttps_epi32(f);
+        __m128 below = _mm_cmpnge_ps(f, _mm_setzero_ps());
+        return _mm_add_epi32(truncated, _mm_castps_si128(below));
+    }
+
+    FNL_TARGET_SSE41
+    static __m128 LerpSSE41(__m128 a, __m128 b, __m128 t)
+    {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    FNL_TARGET_SSE41
+    static __m128 GradCoordSSE41(__m128i seed, __m128i xPrimed, __m128i yPrimed, __m128 xd, __m128 yd)
+    {
+        __m128i hash = _mm_xor_si128(_mm_xor_si128(seed, xPrimed), yPrimed);
+        hash = _mm_mullo_epi32(hash, _mm_set1_epi32(0x27d4eb2d));
+        hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+        hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+        // No gather before AVX2: four scalar loads per component
+        alignas(16) int index[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), hash);
+        const float* gradients = Lookup<float>::Gradients2D;
+        __m128 xg = _mm_setr_ps(gradients[index[0]], gradients[index[1]], gradients[index[2]], gradients[index[3]]);
+        __m128 yg = _mm_setr_ps(gradients[index[0] | 1], gradients[index[1] | 1], gradients[index[2] | 1], gradients[index[3] | 1]);
+
+        return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+    }
+
+    FNL_TARGET_SSE41
+    static __m128 SingleSimplexSSE41(__m128i seed, __m128 x, __m128 y)
+    {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float G2 = (3 - SQRT3) / 6;
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        __m128i i = FastFloorSSE41(x);
+        __m128i j = FastFloorSSE41(y);
+        __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+        __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+        __m128 t = _mm_mul_ps(_mm_add_ps(xi, yi), _mm_set1_ps(G2));
+        __m128 x0 = _mm_sub_ps(xi, t);
+        __m128 y0 = _mm_sub_ps(yi, t);
+
+        i = _mm_mullo_epi32(i, _mm_set1_epi32(PrimeX));
+        j = _mm_mullo_epi32(j, _mm_set1_epi32(PrimeY));
+        const __m128i iNext = _mm_add_epi32(i, _mm_set1_epi32(PrimeX));
+        const __m128i jNext = _mm_add_epi32(j, _mm_set1_epi32(PrimeY));
+
+        __m128 a = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+        __m128 aa = _mm_mul_ps(a, a);
+        __m128 n0 = _mm_mul_ps(_mm_mul_ps(aa, aa), GradCoordSSE41(seed, i, j, x0, y0));
+        n0 = _mm_and_ps(n0, _mm_cmpnle_ps(a, zero));
+
+        const float cT = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+        const float cA = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+        __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cT), t), _mm_add_ps(_mm_set1_ps(cA), a));
+        __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(2 * (float)G2 - 1));
+        __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(2 * (float)G2 - 1));
+        __m128 cc = _mm_mul_ps(c, c);
+        __m128 n2 = _mm_mul_ps(_mm_mul_ps(cc, cc), GradCoordSSE41(seed, iNext, jNext, x2, y2));
+        n2 = _mm_and_ps(n2, _mm_cmpnle_ps(c, zero));
+
+        // Middle corner: (i, j + 1) above the diagonal, (i + 1, j) below it
+        __m128 upper = _mm_cmpgt_ps(y0, x0);
+        __m128 x1 = _mm_add_ps(x0, _mm_blendv_ps(_mm_set1_ps((float)G2 - 1), _mm_set1_ps((float)G2), upper));
+        __m128 y1 = _mm_add_ps(y0, _mm_blendv_ps(_mm_set1_ps((float)G2), _mm_set1_ps((float)G2 - 1), upper));
+        __m128i i1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(iNext), _mm_castsi128_ps(i), upper));
+        __m128i j1 = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(j), _mm_castsi128_ps(jNext), upper));
+        __m128 b = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+        __m128 bb = _mm_mul_ps(b, b);
+        __m128 n1 = _mm_mul_ps(_mm_mul_ps(bb, bb), GradCoordSSE41(seed, i1, j1, x1, y1));
+        n1 = _mm_and_ps(n1, _mm_cmpnle_ps(b, zero));
+
+        return _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), _mm_set1_ps(99.83685446303647f));
+    }
+
+    FNL_TARGET_SSE41
+    static __m128 InterpQuinticSSE41(__m128 t)
+    {
+        __m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6)), _mm_set1_ps(15));
+        inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    FNL_TARGET_SSE41
+    static __m128 SinglePerlinSSE41(__m128i seed, __m128 x, __m128 y)
+    {
+        __m128i x0 = FastFloorSSE41(x);
+        __m128i y0 = FastFloorSSE41(y);
+
+        __m128 xd0 = _mm_sub_ps(x, _mm_cvtepi32_ps(x0));
+        __m128 yd0 = _mm_sub_ps(y, _mm_cvtepi32_ps(y0));
+        __m128 xd1 = _mm_sub_ps(xd0, _mm_set1_ps(1));
+        __m128 yd1 = _mm_sub_ps(yd0, _mm_set1_ps(1));
+
+        __m128 xs = InterpQuinticSSE41(xd0);
+        __m128 ys = InterpQuinticSSE41(yd0);
+
+        x0 = _mm_mullo_epi32(x0, _mm_set1_epi32(PrimeX));
+        y0 = _mm_mullo_epi32(y0, _mm_set1_epi32(PrimeY));
+        __m128i x1 = _mm_add_epi32(x0, _mm_set1_epi32(PrimeX));
+        __m128i y1 = _mm_add_epi32(y0, _mm_set1_epi32(PrimeY));
+
+        __m128 xf0 = LerpSSE41(GradCoordSSE41(seed, x0, y0, xd0, yd0), GradCoordSSE41(seed, x1, y0, xd1, yd0), xs);
+        __m128 xf1 = LerpSSE41(GradCoordSSE41(seed, x0, y1, xd0, yd1), GradCoordSSE41(seed, x1, y1, xd1, yd1), xs);
+
+        return _mm_mul_ps(LerpSSE41(xf0, xf1, ys), _mm_set1_ps(1.4247691104677813f));
+    }
+
+    FNL_TARGET_SSE41
+    __m128 GenNoiseSingleSSE41(__m128i seed, __m128 x, __m128 y) const
+    {
+        return mNoiseType == NoiseType_Perlin ? SinglePerlinSSE41(seed, x, y) : SingleSimplexSSE41(seed, x, y);
+    }
+
+    FNL_TARGET_SSE41
+    void GenGrid2DSSE41(float* out, int xStart, int yStart, int xSize, int ySize, float step) const
+    {
+        const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128 frequency = _mm_set1_ps(mFrequency);
+        const __m128 stepV = _mm_set1_ps(step);
+        const bool skew = mNoiseType == NoiseType_OpenSimplex2;
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const __m128 F2 = _mm_set1_ps(0.5f * (SQRT3 - 1));
+
+        const int vectorEnd = xSize - xSize % 4;
+        for (int j = 0; j < ySize; j++)
+        {
+            const __m128 yGrid = _mm_set1_ps((float)(yStart + j) * step);
+            for (int i = 0; i < vectorEnd; i += 4)
+            {
+                __m128i xi = _mm_add_epi32(_mm_set1_epi32(xStart + i), laneOffsets);
+                __m128 x = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(xi), stepV), frequency);
+                __m128 y = _mm_mul_ps(yGrid, frequency);
+                if (skew)
+                {
+                    __m128 t = _mm_mul_ps(_mm_add_ps(x, y), F2);
+                    x = _mm_add_ps(x, t);
+                    y = _mm_add_ps(y, t);
+                }
+
+                __m128 noise;
+                if (mFractalType == FractalType_FBm)
+                {
+                    int seed = mSeed;
+                    noise = _mm_setzero_ps();
+                    __m128 amp = _mm_set1_ps(mFractalBounding);
+                    for (int octave = 0; octave < mOctaves; octave++)
+                    {
+                        __m128 single = GenNoiseSingleSSE41(_mm_set1_epi32(seed++), x, y);
+                        noise = _mm_add_ps(noise, _mm_mul_ps(single, amp));
+                        __m128 weight = _mm_mul_ps(_mm_min_ps(_mm_add_ps(single, _mm_set1_ps(1)), _mm_set1_ps(2)), _mm_set1_ps(0.5f));
+                        amp = _mm_mul_ps(amp, LerpSSE41(_mm_set1_ps(1.0f), weight, _mm_set1_ps(mWeightedStrength)));
+
+                        x = _mm_mul_ps(x, _mm_set1_ps(mLacunarity));
+                        y = _mm_mul_ps(y, _mm_set1_ps(mLacunarity));
+                        amp = _mm_mul_ps(amp, _mm_set1_ps(mGain));
+                    }
+                }
+                else
+                {
+                    noise = GenNoiseSingleSSE41(_mm_set1_epi32(mSeed), x, y);
+                }
+                _mm_storeu_ps(out + j * xSize + i, noise);
+            }
+            for (int i = vectorEnd; i < xSize; i++) // row tail
+            {
+                out[j * xSize + i] = GetNoise((float)(xStart + i) * step, (float)(yStart + j) * step);
+            }
+        }
+    }
+#endif // FNL_X86_64
 };
 
 template <>
@@ -0,0 +1,182 @@
+#pragma once
+#ifndef FLAT_CHUNK_MAP_H
+#define FLAT_CHUNK_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ----------------------------------------------------------------------------
+// FlatChunkMap<V>
+//
+// Chunk-coordinate -> V map for ChunkHandler.
+// - Keys and values live in two dense arrays (structure of arrays), so walking
+//   every live chunk is a linear scan over values() with no node hopping.
+// - Lookup goes through an open-addressing slot table (linear probing, power of
+//   two size, max load 1/2) that stores the dense index plus a hash tag, and
+//   compares keys only when the tag matches.
+// - Erase swaps the last entry into the hole and uses backward-shift deletion
+//   in the slot table, so there are no tombstones.
+//
+// Pointers/references into values() stay valid until the next insert or erase.
+// ----------------------------------------------------------------------------
+template <typename V>
+class FlatChunkMap {
+public:
+    size_t size() const { return vals.size(); }
+    bool empty() const { return vals.empty(); }
+
+    V* find(const glm::ivec3& key) {
+        const int64_t i = findIndex(key);
+        return i < 0 ? nullptr : &vals[static_cast<size_t>(i)];
+    }
+    const V* find(const glm::ivec3& key) const {
+        const int64_t i = findIndex(key);
+        return i < 0 ? nullptr : &vals[static_cast<size_t>(i)];
+    }
+    bool contains(const glm::ivec3& key) const { return findIndex(key) >= 0; }
+
+    // Inserts a default V if the key is missing
+    V& operator[](const glm::ivec3& key) {
+        const int64_t i = findIndex(key);
+        if (i >= 0) return vals[static_cast<size_t>(i)];
+        return insertNew(key, V());
+    }
+
+    // Inserts or overwrites
+    V& insertOrAssign(const glm::ivec3& key, V&& value) {
+        const int64_t i = findIndex(key);
+        if (i >= 0) return vals[static_cast<size_t>(i)] = std::move(value);
+        return insertNew(key, std::move(value));
+    }
+
+    bool erase(const glm::ivec3& key) {
+        if (slots.empty()) return false;
+        const uint64_t h = hash(key);
+        size_t s = static_cast<size_t>(h) & mask();
+        for (;; s = (s + 1) & mask()) {
+            if (slots[s].index == EMPTY) return false;
+            if (slots[s].tag == tagOf(h) && equal(keys[slots[s].index], key)) break;
+        }
+        const uint32_t hole = slots[s].index;
+        removeSlot(s);
+
+        // Move the last entry into the hole and repoint its slot
+        const uint32_t last = static_cast<uint32_t>(vals.size() - 1);
+        if (hole != last) {
+            slots[slotOf(keys[last])].index = hole;
+            keys[hole] = keys[last];
+            vals[hole] = std::move(vals[last]);
+        }
+        keys.pop_back();
+        vals.pop_back();
+        return true;
+    }
+
+    void clear() {
+        keys.clear();
+        vals.clear();
+        for (Slot& slot : slots) slot.index = EMPTY;
+    }
+
+    void reserve(size_t count) {
+        keys.reserve(count);
+        vals.reserve(count);
+        if (count * 2 > slots.size()) rehash(count * 2);
+    }
+
+    // Dense views, index i of one matches index i of the other
+    const std::vector<glm::ivec3>& keyArray() const { return keys; }
+    std::vector<V>& values() { return vals; }
+    const std::vector<V>& values() const { return vals; }
+
+    // Bytes held by the table (not counting what V itself owns)
+    size_t memoryUsage() const {
+        return keys.capacity() * sizeof(glm::ivec3) + vals.capacity() * sizeof(V) + slots.capacity() * sizeof(Slot);
+    }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t index = EMPTY; // into keys/vals
+        uint32_t tag = 0;       // high hash bits, checked before touching keys
+    };
+
+    // splitmix64 finalizer over the three 21-bit packed coordinates
+    static uint64_t hash(const glm::ivec3& k) {
+        uint64_t x = (static_cast<uint64_t>(static_cast<uint32_t>(k.x)) & 0x1FFFFF)
+            | (static_cast<uint64_t>(static_cast<uint32_t>(k.y)) & 0x1FFFFF) << 21
+            | (static_cast<uint64_t>(static_cast<uint32_t>(k.z)) & 0x1FFFFF) << 42;
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+    static uint32_t tagOf(uint64_t h) { return static_cast<uint32_t>(h >> 32); }
+    static bool equal(const glm::ivec3& a, const glm::ivec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+    size_t mask() const { return slots.size() - 1; }
+
+    int64_t findIndex(const glm::ivec3& key) const {
+        if (slots.empty()) return -1;
+        const uint64_t h = hash(key);
+        for (size_t s = static_cast<size_t>(h) & mask();; s = (s + 1) & mask()) {
+            const Slot& slot = slots[s];
+            if (slot.index == EMPTY) return -1;
+            if (slot.tag == tagOf(h) && equal(keys[slot.index], key)) return slot.index;
+        }
+    }
+
+    // Slot currently pointing at an existing key
+    size_t slotOf(const glm::ivec3& key) const {
+        size_t s = static_cast<size_t>(hash(key)) & mask();
+        while (!equal(keys[slots[s].index], key)) s = (s + 1) & mask();
+        return s;
+    }
+
+    V& insertNew(const glm::ivec3& key, V&& value) {
+        if ((vals.size() + 1) * 2 > slots.size()) rehash(slots.empty() ? 64 : slots.size() * 2);
+        const uint32_t index = static_cast<uint32_t>(vals.size());
+        keys.push_back(key);
+        vals.push_back(std::move(value));
+        placeSlot(hash(key), index);
+        return vals.back();
+    }
+
+    void placeSlot(uint64_t h, uint32_t index) {
+        size_t s = static_cast<size_t>(h) & mask();
+        while (slots[s].index != EMPTY) s = (s + 1) & mask();
+        slots[s].index = index;
+        slots[s].tag = tagOf(h);
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the gap
+    void removeSlot(size_t hole) {
+        for (size_t s = (hole + 1) & mask();; s = (s + 1) & mask()) {
+            if (slots[s].index == EMPTY) break;
+            const size_t home = static_cast<size_t>(hash(keys[slots[s].index])) & mask();
+            // Move s into the hole unless its home lies cyclically in (hole, s]
+            const bool stays = hole <= s ? (hole < home && home <= s) : (hole < home || home <= s);
+            if (stays) continue;
+            slots[hole] = slots[s];
+            hole = s;
+        }
+        slots[hole].index = EMPTY;
+    }
+
+    void rehash(size_t minSlots) {
+        size_t count = 64;
+        while (count < minSlots) count *= 2;
+        slots.assign(count, Slot());
+        for (uint32_t i = 0; i < keys.size(); ++i) placeSlot(hash(keys[i]), i);
+    }
+
+    std::vector<glm::ivec3> keys;
+    std::vector<V> vals;
+    std::vector<Slot> slots;
+};
+
+#endif // FLAT_CHUNK_MAP_H
@@ -0,0 +1,119 @@
+
+#include "GLChunkBackend.h"
+
+GLChunkBackend::~GLChunkBackend() { destroy(); }
+
+// ----------------------------------------------------------------------------
+// initialize(maxTotalQuads):
+//   - Allocates the quad SSBO (maxTotalQuads * sizeof(uint64_t)) and its
+//     staging ring via ChunkBufferManager.
+//   - Allocates the metadata SSBO.
+// ----------------------------------------------------------------------------
+bool GLChunkBackend::initialize(uint32_t maxTotalQuads) {
+    bufferMgr.initialize(maxTotalQuads);
+
+    // Starting size of the metadata SSBO; updateChunkMetadata grows it if needed
+    const uint32_t INITIAL_METADATA_CHUNKS = 10000;
+    createMetadataBuffer(INITIAL_METADATA_CHUNKS);
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// createMetadataBuffer(capacity):
+//   - std430 layout: 'chunkCount' (4 bytes) + 12 bytes of padding so the
+//     'ChunkData' array starts on a 16-byte boundary, then capacity * 32 bytes.
+//   - The new buffer starts empty; the caller uploads every entry into it.
+// ----------------------------------------------------------------------------
+void GLChunkBackend::createMetadataBuffer(uint32_t capacity) {
+    if (metadataSSBO) glDeleteBuffers(1, &metadataSSBO);
+    glCreateBuffers(1, &metadataSSBO);
+
+    size_t metadataBufferSize = 16 + static_cast<size_t>(capacity) * sizeof(ChunkData);
+    glNamedBufferStorage(metadataSSBO, metadataBufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    metadataCapacity = capacity;
+    uploadedChunkCount = UINT32_MAX; // forces the count to be written
+}
+
+void GLChunkBackend::destroy() {
+    if (metadataSSBO) {
+        glDeleteBuffers(1, &metadataSSBO);
+        metadataSSBO = 0;
+    }
+    metadataCapacity = 0;
+    for (const FrameFence& f : frameFences) glDeleteSync(f.sync);
+    frameFences.clear();
+    bufferMgr.destroy();
+}
+
+void GLChunkBackend::uploadChunkQuads(const ChunkQuadUpload* uploads, size_t count) {
+    bufferMgr.stageChunkBatch(uploads, count);
+}
+
+bool GLChunkBackend::growQuadCapacity(uint32_t maxTotalQuads) {
+    bufferMgr.grow(maxTotalQuads);
+    return true;
+}
+
+void GLChunkBackend::copyChunkQuads(uint32_t srcSlot, uint32_t dstSlot, uint32_t quadCount) {
+    bufferMgr.copyWithinHeap(srcSlot, dstSlot, quadCount);
+}
+
+size_t GLChunkBackend::updateChunkMetadata(const ChunkData* data, uint32_t count,
+    const std::vector<ChunkDataRange>& dirty) {
+    size_t bytes = 0;
+
+    if (count > metadataCapacity) {
+        // Outgrown: new buffer, then every entry is uploaded once
+        uint32_t capacity = metadataCapacity ? metadataCapacity : 1;
+        while (capacity < count) capacity *= 2;
+        createMetadataBuffer(capacity);
+        glNamedBufferSubData(metadataSSBO, 16, count * sizeof(ChunkData), data);
+        bytes += count * sizeof(ChunkData);
+    }
+    else {
+        // Array starts at offset 16 (4 bytes count + 12 bytes padding)
+        for (const ChunkDataRange& r : dirty) {
+            const size_t rangeBytes = (r.end - r.begin) * sizeof(ChunkData);
+            glNamedBufferSubData(metadataSSBO, 16 + r.begin * sizeof(ChunkData), rangeBytes, data + r.begin);
+            bytes += rangeBytes;
+        }
+    }
+
+    if (count != uploadedChunkCount) {
+        glNamedBufferSubData(metadataSSBO, 0, sizeof(uint32_t), &count);
+        uploadedChunkCount = count;
+        bytes += sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+void GLChunkBackend::bindQuads(uint32_t bindingPoint) const {
+    bufferMgr.bind(bindingPoint);
+}
+
+void GLChunkBackend::bindMetadata(uint32_t bindingPoint) const {
+    // Bind SSBO to shader slot
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, metadataSSBO);
+}
+
+void GLChunkBackend::clear() {
+    bufferMgr.clear();
+}
+
+void GLChunkBackend::fenceFrame(uint64_t frame) {
+    bufferMgr.endFrame();
+    frameFences.push_back({ frame, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+}
+
+// Polls without blocking: fences signal in submission order, so stop at the first pending one
+uint64_t GLChunkBackend::completedFrames() {
+    while (!frameFences.empty()) {
+        GLenum state = glClientWaitSync(frameFences.front().sync, 0, 0);
+        if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED) break;
+        framesDone = frameFences.front().frame + 1;
+        glDeleteSync(frameFences.front().sync);
+        frameFences.pop_front();
+    }
+    return framesDone;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef GL_CHUNK_BACKEND_H
+#define GL_CHUNK_BACKEND_H
+
+#include <deque>
+#include <glad/glad.h>
+#include "ChunkRenderBackend.h"
+#include "ChunkBufferManager.h"
+
+// ----------------------------------------------------------------------------
+// GLChunkBackend
+//
+// OpenGL implementation of IChunkRenderBackend.
+// - Quad data lives in ChunkBufferManager's SSBO, uploaded through its fenced staging ring.
+// - Per-chunk ChunkData lives in a second SSBO (binding 2 in default.vert).
+//   Slots are stable (slot i = draw i), so each frame only the dirty ranges and
+//   a changed chunkCount are written; the buffer is recreated twice as large
+//   when the chunk count outgrows it.
+// ----------------------------------------------------------------------------
+class GLChunkBackend : public IChunkRenderBackend {
+public:
+    GLChunkBackend() = default;
+    ~GLChunkBackend() override;
+
+    bool initialize(uint32_t maxTotalQuads) override;
+    void destroy() override;
+    bool growQuadCapacity(uint32_t maxTotalQuads) override;
+
+    void uploadChunkQuads(const ChunkQuadUpload* uploads, size_t count) override;
+    void copyChunkQuads(uint32_t srcSlot, uint32_t dstSlot, uint32_t quadCount) override;
+    size_t updateChunkMetadata(const ChunkData* data, uint32_t count,
+        const std::vector<ChunkDataRange>& dirty) override;
+
+    void bindQuads(uint32_t bindingPoint) const override;
+    void bindMetadata(uint32_t bindingPoint) const override;
+
+    void clear() override;
+
+    void fenceFrame(uint64_t frame) override;
+    uint64_t completedFrames() override;
+
+private:
+    ChunkBufferManager bufferMgr;
+    void createMetadataBuffer(uint32_t capacity);
+
+    GLuint metadataSSBO = 0;
+    uint32_t metadataCapacity = 0;       // ChunkData entries the SSBO can hold
+    uint32_t uploadedChunkCount = 0;     // chunkCount currently in the SSBO
+
+    struct FrameFence {
+        uint64_t frame;
+        GLsync sync;
+    };
+    std::deque<FrameFence> frameFences;  // oldest first
+    uint64_t framesDone = 0;
+};
+
+#endif // GL_CHUNK_BACKEND_H
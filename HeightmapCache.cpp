@@ -0,0 +1,53 @@
+#include "HeightmapCache.h"
+
+std::shared_ptr<const HeightmapTile> HeightmapCache::find(const FastNoiseLite* noise, int x, int z) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(Key{ noise, x, z });
+    if (it == index.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    lru.splice(lru.begin(), lru, it->second); // iterators stay valid
+    return it->second->tile;
+}
+
+std::shared_ptr<const HeightmapTile> HeightmapCache::insert(const FastNoiseLite* noise, int x, int z,
+    std::shared_ptr<const HeightmapTile> tile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Key key{ noise, x, z };
+    auto it = index.find(key);
+    if (it != index.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->tile;
+    }
+    lru.push_front(Entry{ key, std::move(tile) });
+    index.emplace(key, lru.begin());
+    std::shared_ptr<const HeightmapTile> resident = lru.front().tile;
+    evictToCapacity();
+    return resident;
+}
+
+void HeightmapCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    lru.clear();
+}
+
+void HeightmapCache::setCapacity(size_t tiles) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = tiles;
+    evictToCapacity();
+}
+
+size_t HeightmapCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lru.size();
+}
+
+void HeightmapCache::evictToCapacity() {
+    while (lru.size() > capacity) {
+        index.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
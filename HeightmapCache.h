@@ -0,0 +1,92 @@
+#pragma once
+#ifndef HEIGHTMAP_CACHE_H
+#define HEIGHTMAP_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "mesher.h" // CS_P
+
+class FastNoiseLite;
+
+// Terrain height (world voxel y of the top solid voxel) of every column of one
+// padded chunk footprint, indexed [z * CS_P + x].
+struct HeightmapTile {
+    int heights[CS_P * CS_P];
+    int minHeight, maxHeight; // over all columns
+};
+
+// ----------------------------------------------------------------------------
+// HeightmapCache
+//
+// Heightmap tiles keyed by a chunk's (x, z) voxel offset and the noise that
+// produced them. Chunks stacked vertically share a footprint, so only the first
+// chunk of a column pays for the noise; the rest reuse its tile.
+// - Least recently used tiles are evicted once more than capacity are held.
+// - Tiles are handed out as shared_ptr, so eviction never pulls a tile out from
+//   under a generator that is still reading it.
+// - Thread-safe: workers look up and insert concurrently. Two workers that miss
+//   on the same column both build it; the first insert wins.
+//
+// Tiles are only valid for the noise settings they were built with: call
+// clear() after changing the settings of a noise that was used for generation.
+// ----------------------------------------------------------------------------
+class HeightmapCache {
+public:
+    explicit HeightmapCache(size_t capacity = 256) : capacity(capacity) {}
+
+    HeightmapCache(const HeightmapCache&) = delete;
+    HeightmapCache& operator=(const HeightmapCache&) = delete;
+
+    // Resident tile for the footprint, marked most recently used; null on a miss
+    std::shared_ptr<const HeightmapTile> find(const FastNoiseLite* noise, int x, int z);
+
+    // Add a freshly built tile. Returns the tile now resident for the footprint,
+    // which is an earlier one if another thread got there first.
+    std::shared_ptr<const HeightmapTile> insert(const FastNoiseLite* noise, int x, int z,
+        std::shared_ptr<const HeightmapTile> tile);
+
+    void clear();
+
+    // Evicts down to the new capacity right away
+    void setCapacity(size_t tiles);
+    size_t getCapacity() const { return capacity; }
+
+    size_t size() const;
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+
+private:
+    struct Key {
+        const FastNoiseLite* noise;
+        int x, z;
+        bool operator==(const Key& o) const { return noise == o.noise && x == o.x && z == o.z; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = reinterpret_cast<uintptr_t>(k.noise);
+            h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(k.x);
+            h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(k.z);
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<const HeightmapTile> tile;
+    };
+
+    void evictToCapacity();
+
+    mutable std::mutex mutex;
+    std::list<Entry> lru; // front = most recently used
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    size_t capacity;
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+};
+
+#endif // HEIGHTMAP_CACHE_H
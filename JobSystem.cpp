@@ -0,0 +1,108 @@
+
+#include "JobSystem.h"
+
+namespace {
+// Index of the worker running on this thread, or -1 outside the pool
+thread_local int tlsWorkerIndex = -1;
+thread_local const void* tlsWorkerOwner = nullptr;
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+    if (workerCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    // Workers keep their own follow-up jobs local; external submits are spread out
+    unsigned target = (tlsWorkerOwner == this && tlsWorkerIndex >= 0)
+        ? static_cast<unsigned>(tlsWorkerIndex)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    pendingJobs.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->jobs.push_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedJobs.fetch_add(1, std::memory_order_acq_rel);
+    }
+    workAvailable.notify_one();
+}
+
+bool JobSystem::tryRunOne(unsigned selfIndex) {
+    std::function<void()> job;
+    const unsigned count = static_cast<unsigned>(queues.size());
+
+    // Own queue first (LIFO, still warm in cache), then steal the oldest job from the others
+    for (unsigned n = 0; n < count && !job; ++n) {
+        unsigned index = (selfIndex + n) % count;
+        WorkerQueue& q = *queues[index];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.jobs.empty()) continue;
+        if (n == 0 && tlsWorkerOwner == this) {
+            job = std::move(q.jobs.back());
+            q.jobs.pop_back();
+        }
+        else {
+            job = std::move(q.jobs.front());
+            q.jobs.pop_front();
+        }
+    }
+    if (!job) return false;
+
+    queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+    job();
+
+    if (pendingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        allDone.notify_all();
+    }
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    tlsWorkerIndex = static_cast<int>(index);
+    tlsWorkerOwner = this;
+    for (;;) {
+        if (tryRunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        workAvailable.wait(lock, [this] {
+            return stopping || queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queuedJobs.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+void JobSystem::wait() {
+    // Help out from the calling thread, then sleep until the last job finishes
+    unsigned start = nextQueue.load(std::memory_order_relaxed) % queues.size();
+    while (pendingJobs.load(std::memory_order_acquire) > 0) {
+        if (tryRunOne(start)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        allDone.wait(lock, [this] {
+            return pendingJobs.load(std::memory_order_acquire) == 0
+                || queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// JobSystem
+//
+// Small work-stealing thread pool for chunk generation and meshing.
+// - Every worker owns a deque: it pushes/pops its own jobs at the back and
+//   steals from the front of other workers' deques when it runs dry.
+// - Jobs submitted from outside the pool are spread round-robin.
+// - wait() blocks until every submitted job has finished; the calling thread
+//   runs jobs too instead of idling.
+//
+// Per-thread scratch memory is expected to be thread_local in the job code,
+// so jobs never share buffers.
+// ----------------------------------------------------------------------------
+class JobSystem {
+public:
+    // workerCount = 0 picks hardware_concurrency() - 1 (at least 1)
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(std::function<void()> job);
+
+    // Waits for all submitted jobs (not just the caller's), so don't call it from inside a job
+    void wait();
+
+    // Runs fn(i) for i in [0, count) across the pool and waits for all of them
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        for (size_t i = 0; i < count; ++i) {
+            submit([&fn, i]() { fn(i); });
+        }
+        wait();
+    }
+
+    unsigned getWorkerCount() const { return static_cast<unsigned>(threads.size()); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    void workerLoop(unsigned index);
+    bool tryRunOne(unsigned selfIndex);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues; // one per worker
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> queuedJobs{ 0 };  // sitting in a deque
+    std::atomic<size_t> pendingJobs{ 0 }; // submitted and not finished
+    std::atomic<unsigned> nextQueue{ 0 };
+    bool stopping = false;
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+};
+
+#endif // JOB_SYSTEM_H
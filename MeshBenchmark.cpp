@@ -0,0 +1,377 @@
+// MeshBenchmark.cpp
+//
+// Headless meshing benchmark. Runs the opaque-mask pass used by ChunkHandler::generateMeshData
+// and mesh() from mesher.cpp over a fixed corpus of padded 64^3 volumes and prints
+// chunks/sec, ns/voxel, quads emitted and peak RSS, followed by the opaque-mask pass on
+// each SIMD path (scalar / SSE2 / AVX2), chunk generation with the mask pass vs the
+// masks filled during generation, per-point vs batched heightmap noise, small-brush remeshing (full vs dirty layers
+// spliced into a ChunkMesh) and the compressed size and decode time of the same
+// volumes in ChunkVoxels. Links only teleios_core, so no GL
+// context or window is needed.
+//
+// Usage: MeshBenchmark [iterations]   (default 200 iterations per corpus entry)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ChunkHandler.h"
+#include "ChunkMesh.h"
+#include "ChunkVoxels.h"
+#include "MeshWorkspace.h"
+#include "mesher.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const int kTerrainMaterial = 2;
+
+struct Volume {
+    explicit Volume(std::string volumeName) : name(std::move(volumeName)) {}
+
+    std::string name;
+    std::vector<std::vector<uint8_t>> chunks; // each one CS_P3 voxels, ZXY order
+};
+
+size_t peakRssKiB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<size_t>(pmc.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss);        // KiB on Linux
+#endif
+#endif
+}
+
+inline size_t voxelIndex(int x, int y, int z) {
+    // Same flattening as ChunkHandler::generateVoxelsWithSDF
+    return static_cast<size_t>(z + (x * CS_P) + (y * CS_P2));
+}
+
+// Terrain + SDF edits through the same path the engine uses for new chunks.
+void fillTerrain(std::vector<uint8_t>& voxels, ChunkHandler& handler, glm::ivec3 chunkCoords,
+    const std::vector<std::unique_ptr<ISDFEdit>>& edits) {
+    handler.generateVoxelsWithSDF(voxels, CS_P, CS_P2, CS_P3, chunkCoords * CS,
+        ChunkHandler::sharedNoise, edits);
+}
+
+// Air spheres scattered through a chunk's world-space bounds, like an SDFSphereEdit brush with material 0.
+std::vector<std::unique_ptr<ISDFEdit>> caveEdits(glm::ivec3 chunkCoords, std::mt19937& rng, int sphereCount) {
+    const float chunkWorldSize = CS * ChunkHandler::voxel_scale;
+    std::uniform_real_distribution<float> pos(0.0f, chunkWorldSize);
+    std::uniform_real_distribution<float> rad(0.3f, 1.2f);
+    std::vector<std::unique_ptr<ISDFEdit>> edits;
+    for (int i = 0; i < sphereCount; ++i) {
+        glm::vec3 center = glm::vec3(chunkCoords) * chunkWorldSize + glm::vec3(pos(rng), pos(rng), pos(rng));
+        edits.push_back(std::make_unique<SDFSphereEdit>(center, rad(rng), 0));
+    }
+    return edits;
+}
+
+std::vector<Volume> buildCorpus() {
+    std::vector<Volume> corpus;
+
+    Volume empty{ "empty" };
+    empty.chunks.emplace_back(CS_P3, 0);
+    corpus.push_back(std::move(empty));
+
+    Volume solid{ "solid" };
+    solid.chunks.emplace_back(CS_P3, kTerrainMaterial);
+    corpus.push_back(std::move(solid));
+
+    // Worst case: every solid voxel is isolated, so nothing merges and every face is emitted.
+    Volume checker{ "checkerboard" };
+    checker.chunks.emplace_back(CS_P3, 0);
+    for (int y = 0; y < CS_P; ++y)
+        for (int x = 0; x < CS_P; ++x)
+            for (int z = 0; z < CS_P; ++z)
+                if ((x + y + z) & 1) checker.chunks.back()[voxelIndex(x, y, z)] = static_cast<uint8_t>(1 + ((x + z) & 3));
+    corpus.push_back(std::move(checker));
+
+    // Headless handler: generation only, never initialized with a backend
+    ChunkHandler handler;
+    const std::vector<std::unique_ptr<ISDFEdit>> noEdits;
+
+    // A row of surface chunks, like the y = 0 layer of the world built in main()
+    Volume terrain{ "terrain" };
+    for (int i = 0; i < 8; ++i) {
+        terrain.chunks.emplace_back();
+        fillTerrain(terrain.chunks.back(), handler, glm::ivec3(i, 0, i / 2), noEdits);
+    }
+    corpus.push_back(std::move(terrain));
+
+    // Mostly buried chunks with SDF spheres carved out
+    Volume caves{ "caves" };
+    std::mt19937 rng(1337);
+    for (int i = 0; i < 8; ++i) {
+        const glm::ivec3 coords(i, -1, i / 2);
+        caves.chunks.emplace_back();
+        fillTerrain(caves.chunks.back(), handler, coords, caveEdits(coords, rng, 24));
+    }
+    corpus.push_back(std::move(caves));
+
+    return corpus;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 200;
+    if (argc > 1) iterations = std::max(1, std::atoi(argv[1]));
+
+    std::cout << "Building corpus...\n";
+    std::vector<Volume> corpus = buildCorpus();
+
+    // Same scratch buffers ChunkHandler::generateMeshData meshes into
+    MeshWorkspace workspace;
+
+    std::cout << "iterations per volume: " << iterations << "\n\n";
+    std::cout << std::left << std::setw(14) << "volume"
+        << std::right << std::setw(12) << "chunks/s"
+        << std::setw(12) << "ns/voxel"
+        << std::setw(12) << "mask us"
+        << std::setw(12) << "mesh us"
+        << std::setw(12) << "quads" << "\n";
+
+    using clock = std::chrono::steady_clock;
+    for (const Volume& volume : corpus) {
+        double maskNs = 0.0, meshNs = 0.0;
+        size_t quads = 0;
+        int meshed = 0;
+
+        for (int it = 0; it < iterations; ++it) {
+            for (const std::vector<uint8_t>& voxels : volume.chunks) {
+                MeshData& meshData = workspace.reset();
+                auto t0 = clock::now();
+                buildOpaqueMask(voxels.data(), meshData.opaqueMask);
+                auto t1 = clock::now();
+                mesh(voxels.data(), meshData);
+                auto t2 = clock::now();
+
+                maskNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                meshNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+                if (it == 0) {
+                    for (int face = 0; face < 6; ++face) quads += meshData.faceVertexLength[face];
+                }
+                ++meshed;
+            }
+        }
+
+        const double totalNs = maskNs + meshNs;
+        std::cout << std::left << std::setw(14) << volume.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << meshed / (totalNs * 1e-9)
+            << std::setw(12) << std::setprecision(3) << totalNs / (double(meshed) * CS_P3)
+            << std::setw(12) << std::setprecision(1) << maskNs / meshed * 1e-3
+            << std::setw(12) << std::setprecision(1) << meshNs / meshed * 1e-3
+            << std::setw(12) << quads / volume.chunks.size() << "\n";
+    }
+
+    // Opaque mask pass per code path, checked against the scalar result
+    const char* pathNames[] = { "scalar", "sse2", "avx2" };
+    std::cout << "\nopaque mask (selected: " << pathNames[getOpaqueMaskPath()] << ")\n"
+        << std::left << std::setw(14) << "path"
+        << std::right << std::setw(12) << "mask us"
+        << std::setw(12) << "speedup" << "\n";
+    std::vector<uint64_t> reference(CS_P2), candidate(CS_P2);
+    double scalarNs = 0.0;
+    for (int path = OPAQUE_MASK_SCALAR; path <= OPAQUE_MASK_AVX2; ++path) {
+        double pathNs = 0.0;
+        int built = 0;
+        bool matches = true;
+        for (const Volume& volume : corpus) {
+            for (const std::vector<uint8_t>& voxels : volume.chunks) {
+                buildOpaqueMaskWithPath(OPAQUE_MASK_SCALAR, voxels.data(), reference.data());
+                if (!buildOpaqueMaskWithPath(static_cast<OpaqueMaskPath>(path), voxels.data(), candidate.data())) continue;
+                matches = matches && reference == candidate;
+
+                auto t0 = clock::now();
+                for (int it = 0; it < iterations; ++it) {
+                    buildOpaqueMaskWithPath(static_cast<OpaqueMaskPath>(path), voxels.data(), candidate.data());
+                }
+                pathNs += std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+                built += iterations;
+            }
+        }
+        std::cout << std::left << std::setw(14) << pathNames[path] << std::right;
+        if (built == 0) {
+            std::cout << std::setw(12) << "n/a" << "\n";
+            continue;
+        }
+        const double perChunkNs = pathNs / built;
+        if (path == OPAQUE_MASK_SCALAR) scalarNs = perChunkNs;
+        std::cout << std::fixed
+            << std::setw(12) << std::setprecision(1) << perChunkNs * 1e-3
+            << std::setw(11) << std::setprecision(2) << scalarNs / perChunkNs << "x"
+            << (matches ? "" : "   MISMATCH") << "\n";
+    }
+
+    // Heightmap noise: one GetNoise per column vs the batched grid, checked against each other
+    {
+        const int footprint = CS_P * CS_P;
+        std::vector<float> pointNoise(footprint), gridNoise(footprint);
+        double pointNs = 0.0, gridNs = 0.0, maxDiff = 0.0;
+        for (int i = 0; i < 8; ++i) {
+            const int originX = i * CS - 1, originZ = (i / 2) * CS - 1; // padded footprint of chunk (i, *, i / 2)
+            for (int it = 0; it < iterations; ++it) {
+                auto t0 = clock::now();
+                for (int z = 0; z < CS_P; ++z)
+                    for (int x = 0; x < CS_P; ++x)
+                        pointNoise[z * CS_P + x] = ChunkHandler::sharedNoise.GetNoise(
+                            (originX + x) * ChunkHandler::voxel_scale, (originZ + z) * ChunkHandler::voxel_scale);
+                auto t1 = clock::now();
+                ChunkHandler::sharedNoise.GetNoiseGrid2D(gridNoise.data(), originX, originZ, CS_P, CS_P, ChunkHandler::voxel_scale);
+                auto t2 = clock::now();
+                pointNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                gridNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+            }
+            for (int p = 0; p < footprint; ++p) maxDiff = std::max(maxDiff, double(std::fabs(pointNoise[p] - gridNoise[p])));
+        }
+        const double samples = 8.0 * iterations;
+        std::cout << "\n" << std::left << std::setw(14) << "noise" << std::right
+            << std::setw(12) << "point us" << std::setw(12) << "grid us" << std::setw(12) << "speedup" << "\n"
+            << std::left << std::setw(14) << "heightmap" << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << pointNs / samples * 1e-3
+            << std::setw(12) << std::setprecision(1) << gridNs / samples * 1e-3
+            << std::setw(11) << std::setprecision(2) << pointNs / gridNs << "x"
+            << (maxDiff == 0.0 ? "" : "   MISMATCH") << "\n";
+    }
+
+    // Generation: terrain + edits, then the mask pass, vs the masks filled while generating.
+    // Caves spend their time in the edit SDFs, so expect the two columns to match there.
+    std::cout << "\n" << std::left << std::setw(14) << "generation"
+        << std::right << std::setw(12) << "split us"
+        << std::setw(12) << "fused us" << "\n";
+    {
+        ChunkHandler generator;
+        std::vector<uint8_t> scratch(CS_P3);
+        std::vector<uint64_t> splitMask(CS_P2), fusedMask(CS_P2);
+        const int genIterations = std::max(1, iterations / 10); // noise dominates, keep it short
+        for (int chunkY : { 0, -1 }) {
+            std::mt19937 editRng(1337);
+            double splitNs = 0.0, fusedNs = 0.0;
+            int generated = 0;
+            bool matches = true;
+            for (int i = 0; i < 8; ++i) {
+                const glm::ivec3 coords(i, chunkY, i / 2);
+                const auto edits = chunkY < 0 ? caveEdits(coords, editRng, 24) : std::vector<std::unique_ptr<ISDFEdit>>();
+                for (int it = 0; it < genIterations; ++it) {
+                    auto t0 = clock::now();
+                    generator.generateVoxelsWithSDF(scratch, CS_P, CS_P2, CS_P3, coords * CS,
+                        ChunkHandler::sharedNoise, edits);
+                    buildOpaqueMask(scratch.data(), splitMask.data());
+                    auto t1 = clock::now();
+                    generator.generateVoxelsWithSDF(scratch, CS_P, CS_P2, CS_P3, coords * CS,
+                        ChunkHandler::sharedNoise, edits, fusedMask.data());
+                    auto t2 = clock::now();
+
+                    splitNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                    fusedNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+                    matches = matches && splitMask == fusedMask;
+                    ++generated;
+                }
+            }
+            std::cout << std::left << std::setw(14) << (chunkY < 0 ? "caves" : "terrain") << std::right << std::fixed
+                << std::setw(12) << std::setprecision(1) << splitNs / generated * 1e-3
+                << std::setw(12) << std::setprecision(1) << fusedNs / generated * 1e-3
+                << (matches ? "" : "   MISMATCH") << "\n";
+        }
+    }
+
+    // Sculpting: one small brush per remesh, full mesh() vs dirty layers + splice
+    std::cout << "\n" << std::left << std::setw(14) << "small edit"
+        << std::right << std::setw(12) << "full us"
+        << std::setw(12) << "layers us" << "\n";
+    for (const Volume& volume : corpus) {
+        if (volume.name != "terrain" && volume.name != "caves") continue;
+        ChunkHandler editor;
+        std::mt19937 brushRng(7);
+        std::uniform_real_distribution<float> brushPos(0.0f, CS * ChunkHandler::voxel_scale);
+        double fullNs = 0.0, layersNs = 0.0;
+        int edits = 0;
+        for (const std::vector<uint8_t>& voxels : volume.chunks) {
+            ChunkVoxels stored;
+            stored.assign(std::vector<uint8_t>(voxels));
+            std::vector<uint64_t>& mask = stored.opaqueMask();
+            ChunkMesh chunkMesh;
+            const MeshData& first = editor.generateMeshData(stored.raw(), mask.data());
+            chunkMesh.assign(first.vertices->data(), first.vertexCount);
+
+            for (int it = 0; it < iterations; ++it) {
+                // Chunk-local brush: the volume's world offset doesn't matter for timing
+                SDFSphereEdit brush(glm::vec3(brushPos(brushRng), brushPos(brushRng), brushPos(brushRng)),
+                    0.2f, static_cast<uint8_t>(it & 1 ? 0 : kTerrainMaterial));
+                ChunkHandler::applySDFEdit(stored.raw(), mask.data(), glm::ivec3(0), brush);
+
+                uint64_t dirtyLayers[6] = {};
+                glm::ivec3 lo, hi;
+                if (ChunkHandler::editLocalBounds(glm::ivec3(0), brush, lo, hi)) {
+                    ChunkMesh::dirtyLayersForBox(lo.x, lo.y, lo.z, hi.x, hi.y, hi.z, dirtyLayers);
+                }
+                auto t0 = clock::now();
+                const MeshData& partial = editor.generateMeshData(stored.raw(), mask.data(), dirtyLayers);
+                chunkMesh.splice(dirtyLayers, partial.vertices->data(), partial.vertexCount);
+                auto t1 = clock::now();
+                editor.generateMeshData(stored.raw(), mask.data());
+                auto t2 = clock::now();
+
+                layersNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                fullNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+                ++edits;
+            }
+        }
+        std::cout << std::left << std::setw(14) << volume.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << fullNs / edits * 1e-3
+            << std::setw(12) << std::setprecision(1) << layersNs / edits * 1e-3 << "\n";
+    }
+
+    // Resident storage: compressed size and bulk decode back into the mesher layout
+    std::cout << "\n" << std::left << std::setw(14) << "volume"
+        << std::right << std::setw(12) << "KiB/chunk"
+        << std::setw(12) << "decode us" << "\n";
+    std::vector<uint8_t> decoded(CS_P3);
+    for (const Volume& volume : corpus) {
+        size_t bytes = 0;
+        double decodeNs = 0.0;
+        for (const std::vector<uint8_t>& voxels : volume.chunks) {
+            ChunkVoxels stored;
+            stored.assign(std::vector<uint8_t>(voxels));
+            stored.compress();
+            bytes += stored.memoryUsage();
+
+            auto t0 = clock::now();
+            for (int it = 0; it < iterations; ++it) stored.decode(decoded.data());
+            decodeNs += std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        }
+        const double chunkCount = static_cast<double>(volume.chunks.size());
+        std::cout << std::left << std::setw(14) << volume.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << bytes / 1024.0 / chunkCount
+            << std::setw(12) << std::setprecision(1) << decodeNs / (chunkCount * iterations) * 1e-3 << "\n";
+    }
+
+    std::cout << "\npeak RSS: " << peakRssKiB() / 1024.0 << " MiB\n";
+    return 0;
+}
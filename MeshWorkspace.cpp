@@ -0,0 +1,42 @@
+
+#include "MeshWorkspace.h"
+#include <cstring> // for std::memset
+
+MeshWorkspace::MeshWorkspace()
+    : faceMasks(new uint64_t[CS_2 * 6]()),
+      opaqueMask(new uint64_t[CS_P2]()),
+      forwardMerged(new uint8_t[CS_2]()),
+      rightMerged(new uint8_t[CS]()),
+      voxels(CS_P3),
+      voxelMask(CS_P2) {
+    // Same starting size generateMeshData used; mesh() doubles it if a chunk needs more
+    meshData.maxVertices = CS_P * CS_P * CS_P * 6 / 2;
+    vertices.resize(meshData.maxVertices);
+
+    meshData.faceMasks = faceMasks.get();
+    meshData.opaqueMask = opaqueMask.get();
+    meshData.forwardMerged = forwardMerged.get();
+    meshData.rightMerged = rightMerged.get();
+    meshData.vertices = &vertices;
+}
+
+MeshData& MeshWorkspace::reset() {
+    // faceMasks and opaqueMask are fully rewritten by every pass. mesh() leaves the
+    // merge counters at zero, clearing them again only guards against an aborted run.
+    std::memset(forwardMerged.get(), 0, CS_2);
+    std::memset(rightMerged.get(), 0, CS);
+
+    meshData.opaqueMask = opaqueMask.get(); // may have been pointed at a chunk's own masks
+    meshData.vertexCount = 0;
+    meshData.maxVertices = static_cast<int>(vertices.size());
+    for (int face = 0; face < 6; ++face) {
+        meshData.faceVertexBegin[face] = 0;
+        meshData.faceVertexLength[face] = 0;
+    }
+    return meshData;
+}
+
+MeshWorkspace& MeshWorkspace::forThread() {
+    thread_local MeshWorkspace workspace;
+    return workspace;
+}
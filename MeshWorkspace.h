@@ -0,0 +1,56 @@
+#pragma once
+#ifndef MESH_WORKSPACE_H
+#define MESH_WORKSPACE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "mesher.h"
+
+// ----------------------------------------------------------------------------
+// MeshWorkspace
+//
+// Owns the scratch buffers mesh() works in (faceMasks, opaqueMask,
+// forwardMerged, rightMerged and the quad output), plus a padded voxel volume
+// and opaque mask for generating the chunk to be meshed. Everything is
+// allocated once; reset() only clears the merge counters, so meshing a chunk
+// does no heap allocation unless a chunk needs more quads than any chunk before it.
+//
+// Not thread-safe: use one per thread (forThread()).
+// ----------------------------------------------------------------------------
+class MeshWorkspace {
+public:
+    MeshWorkspace();
+
+    MeshWorkspace(const MeshWorkspace&) = delete;
+    MeshWorkspace& operator=(const MeshWorkspace&) = delete;
+
+    // Returns the MeshData wired to this workspace, ready for buildOpaqueMask() + mesh().
+    // The previous result is overwritten.
+    MeshData& reset();
+
+    // Result of the last mesh(): quads [0, vertexCount) of vertices
+    const MeshData& data() const { return meshData; }
+    const uint64_t* quads() const { return vertices.data(); }
+    size_t quadCount() const { return static_cast<size_t>(meshData.vertexCount); }
+
+    // Generation scratch: CS_P3 voxels and their CS_P2 opaque mask rows. Contents are
+    // whatever the last chunk left there, generators overwrite every entry.
+    std::vector<uint8_t>& chunkVoxels() { return voxels; }
+    std::vector<uint64_t>& chunkMask() { return voxelMask; }
+
+    // The calling thread's workspace, created on first use
+    static MeshWorkspace& forThread();
+
+private:
+    std::unique_ptr<uint64_t[]> faceMasks;
+    std::unique_ptr<uint64_t[]> opaqueMask;
+    std::unique_ptr<uint8_t[]> forwardMerged;
+    std::unique_ptr<uint8_t[]> rightMerged;
+    BM_VECTOR<uint64_t> vertices; // kept at maxVertices entries, mesh() writes by index
+    std::vector<uint8_t> voxels;
+    std::vector<uint64_t> voxelMask;
+    MeshData meshData;
+};
+
+#endif // MESH_WORKSPACE_H
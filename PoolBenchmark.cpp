@@ -0,0 +1,116 @@
+// PoolBenchmark.cpp
+//
+// Drives the UniversalPool the way ChunkHandler does while chunks are remeshed:
+// fill the heap with chunk-sized blocks, then repeatedly free random blocks and
+// allocate replacements of a new random size. Reports ns per allocate /
+// deallocate, failed allocations and the free-space picture from getStats().
+// Live blocks are checked for overlap at the end.
+//
+// Usage: PoolBenchmark [churnOps]   (default 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "UniversalPool.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsedNs(clock_type::time_point t0) {
+    return std::chrono::duration<double, std::nano>(clock_type::now() - t0).count();
+}
+
+void printStats(const char* label, const PoolStats& s) {
+    std::cout << std::left << std::setw(10) << label << std::right
+        << "  used " << std::setw(10) << s.usedSize
+        << "  free " << std::setw(10) << s.freeSize
+        << "  largest free " << std::setw(10) << s.largestFreeBlock
+        << "  free blocks " << std::setw(7) << s.freeBlockCount
+        << "  fragmentation " << std::fixed << std::setprecision(3) << s.fragmentation() << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long churnOps = 1000000;
+    if (argc > 1) churnOps = std::max(1L, std::atol(argv[1]));
+
+    // 64M quads, chunk meshes between a few hundred and ~60k quads
+    const uint32_t capacity = 64u << 20;
+    UniversalPool<uint64_t, true> pool(capacity, /*ownsMemory=*/false);
+    std::mt19937 rng(42);
+    std::lognormal_distribution<double> quadCount(8.5, 1.0);
+    auto nextSize = [&] { return static_cast<uint32_t>(std::min(60000.0, quadCount(rng))); };
+
+    std::vector<int> live;
+    int nodeID;
+    while (pool.allocate(nodeID, nextSize())) {
+        live.push_back(nodeID);
+        if (pool.getStats().freeSize < capacity / 4) break; // leave room to churn in
+    }
+    printStats("filled", pool.getStats());
+
+    double allocNs = 0, freeNs = 0;
+    long allocs = 0, failures = 0;
+    for (long op = 0; op < churnOps; ++op) {
+        const size_t victim = rng() % live.size();
+        auto t0 = clock_type::now();
+        pool.deallocate(live[victim]);
+        freeNs += elapsedNs(t0);
+
+        const uint32_t size = nextSize();
+        t0 = clock_type::now();
+        const bool ok = pool.allocate(nodeID, size);
+        allocNs += elapsedNs(t0);
+        ++allocs;
+        if (ok) {
+            live[victim] = nodeID;
+        }
+        else {
+            ++failures;
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+    printStats("churned", pool.getStats());
+
+    std::cout << churnOps << " churn ops: allocate " << std::fixed << std::setprecision(1)
+        << allocNs / allocs << " ns, deallocate " << freeNs / churnOps << " ns, "
+        << failures << " failed allocations\n";
+
+    // Live blocks must not overlap and must stay inside the pool
+    std::vector<MemoryBlock> blocks;
+    for (int id : live) blocks.push_back(pool.getBlock(id));
+    std::sort(blocks.begin(), blocks.end(),
+        [](const MemoryBlock& a, const MemoryBlock& b) { return a.position < b.position; });
+    uint64_t end = 0, used = 0;
+    for (const MemoryBlock& b : blocks) {
+        if (b.position < end || uint64_t(b.position) + b.size > capacity) {
+            std::cerr << "overlapping or out-of-range block at " << b.position << "\n";
+            return 1;
+        }
+        end = uint64_t(b.position) + b.size;
+        used += b.size;
+    }
+    if (used != pool.getStats().usedSize) {
+        std::cerr << "usedSize mismatch: " << used << " vs " << pool.getStats().usedSize << "\n";
+        return 1;
+    }
+
+    // Freeing everything must coalesce back into a single block
+    for (int id : live) pool.deallocate(id);
+    const PoolStats empty = pool.getStats();
+    printStats("emptied", empty);
+    if (empty.freeBlockCount != 1 || empty.largestFreeBlock != capacity) {
+        std::cerr << "free space did not coalesce\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef SDF_EDIT_H
+#define SDF_EDIT_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <glm/glm.hpp>  // For glm::distance, glm::length, glm::abs
+
+// ----------------------------------------------------------------------------
+// Base SDF Edit Interface
+// ----------------------------------------------------------------------------
+struct ISDFEdit {
+    // Pure virtual function to get the signed distance from a world point to the SDF shape
+    virtual float getSignedDistance(glm::vec3 point) const = 0;
+    // Pure virtual function to get the material type for the SDF shape
+    virtual uint8_t getMaterial() const = 0;
+
+    // NEW: Pure virtual function to get the approximate world-space bounding box of the SDF shape.
+    // This is crucial for the generic `addSDFEditAtWorldPos` to determine affected chunks.
+    // Returns a pair of glm::vec3: first is min, second is max.
+    virtual std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const = 0;
+
+    // NEW: Pure virtual function to clone the object polymorphically.
+    // This is necessary because addSDFEditAtWorldPos needs to make copies
+    // of the ISDFEdit object for each chunk it affects.
+    virtual std::unique_ptr<ISDFEdit> clone() const = 0;
+
+    // Virtual destructor for proper polymorphic deletion
+    virtual ~ISDFEdit() = default;
+};
+
+// ----------------------------------------------------------------------------
+// SDF Sphere Edit Structure
+// Inherits from ISDFEdit
+// ----------------------------------------------------------------------------
+struct SDFSphereEdit : public ISDFEdit {
+    glm::vec3 center;  // World coordinates of the sphere's center
+    float radius;      // Radius of the sphere
+    uint8_t material;  // Material type (0 for air, non-zero for solid)
+
+    // Constructor
+    SDFSphereEdit(glm::vec3 c, float r, uint8_t m) : center(c), radius(r), material(m) {}
+
+    // Implement getSignedDistance for sphere
+    float getSignedDistance(glm::vec3 point) const override {
+        return glm::distance(point, center) - radius;
+    }
+
+    // Implement getMaterial for sphere
+    uint8_t getMaterial() const override {
+        return material;
+    }
+
+    // Implement getApproximateWorldBounds for sphere
+    std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const override {
+        glm::vec3 worldMin = center - glm::vec3(radius);
+        glm::vec3 worldMax = center + glm::vec3(radius);
+        return { worldMin, worldMax };
+    }
+
+    // Implement clone for SDFSphereEdit
+    std::unique_ptr<ISDFEdit> clone() const override {
+        return std::make_unique<SDFSphereEdit>(*this); // Use copy constructor
+    }
+};
+
+// ----------------------------------------------------------------------------
+// SDF Cube Edit Structure
+// Inherits from ISDFEdit
+// ----------------------------------------------------------------------------
+struct SDFCubeEdit : public ISDFEdit {
+    glm::vec3 center;     // World coordinates of the cube's center
+    glm::vec3 halfExtents;  // Half-extents of the cube along each axis
+    uint8_t material;     // Material type (0 for air, non-zero for solid)
+
+    // Constructor
+    SDFCubeEdit(glm::vec3 c, glm::vec3 he, uint8_t m) : center(c), halfExtents(he), material(m) {}
+
+    // Implement getSignedDistance for cube (based on standard SDF for AABB)
+    float getSignedDistance(glm::vec3 p) const override {
+        glm::vec3 q = glm::abs(p - center) - halfExtents;
+        return glm::length(glm::max(q, 0.0f)) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f);
+    }
+
+    // Implement getMaterial for cube
+    uint8_t getMaterial() const override {
+        return material;
+    }
+
+    // Implement getApproximateWorldBounds for cube
+    std::pair<glm::vec3, glm::vec3> getApproximateWorldBounds() const override {
+        glm::vec3 worldMin = center - halfExtents;
+        glm::vec3 worldMax = center + halfExtents;
+        return { worldMin, worldMax };
+    }
+
+    // Implement clone for SDFCubeEdit
+    std::unique_ptr<ISDFEdit> clone() const override {
+        return std::make_unique<SDFCubeEdit>(*this); // Use copy constructor
+    }
+};
+
+#endif // SDF_EDIT_H
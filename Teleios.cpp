@@ -24,6 +24,7 @@
 //#define BM_IMPLEMENTATION
 #include"mesher.h"
 #include"ChunkHandler.h"
+#include"GLChunkBackend.h"
 
 
 uint32_t window_size_x = 1600;
@@ -296,31 +297,28 @@ int main() {
     //MeshData meshData0 = generateVoxelMesh(1,);
     //MeshData meshData1 = generateVoxelMesh(0);
 
-    // 2. Create & init the ChunkHandler:
+    // 2. Create & init the ChunkHandler with the OpenGL backend:
+    GLChunkBackend glBackend;
     ChunkHandler handler;
-    bool ok = handler.init(/*maxTotalQuads=*/10'000'0000u);
+    bool ok = handler.init(/*initialQuads=*/1u << 20, &glBackend); // 8 MiB, grows with the world
 
 
+    std::vector<glm::ivec3> startupChunks;
     for (int x = 0; x < 10; ++x) {
         for (int y = 0; y < 10; ++y) {
             for (int z = 0; z < 10; ++z) {
-                std::vector<std::unique_ptr<ISDFEdit>> blankSphereEdits;
-
-                glm::ivec3 coords = { x, z,  y};
-                glm::ivec3 offsetInVoxels = coords * 62;
-                MeshData meshData = handler.generateVoxelMesh(2, offsetInVoxels, handler.sharedNoise, blankSphereEdits);
-
-
-                std::vector<uint64_t> data = *meshData.vertices;
-                handler.addOrUpdateChunk(coords, data);
+                startupChunks.push_back({ x, z,  y });
             }
         }
     }
+    // Generates voxels and meshes on the worker threads, keeps the voxels resident for later edits
+    handler.generateChunks(startupChunks);
     
     // Now that both chunks are in `chunkMap`, we can bind both SSBOs:
     
 
     std::cout << "Loaded chunks: " << handler.getLoadedChunkCount() << "\n"; // should print 2
+    std::cout << "Resident voxel memory: " << handler.getVoxelMemoryUsage() / (1024.0 * 1024.0) << " MiB\n";
 
 
     //// 4. Add chunk #1 at coords (1,0,0):
@@ -414,6 +412,9 @@ int main() {
 
         }
 
+        // Chunks that were not edited this frame go back to compressed voxels
+        handler.compressIdleChunks();
+
 
                
         cam.ProcessKeyboard(window, dt);
@@ -424,9 +425,15 @@ int main() {
         cam.SetViewMatrixUniform(shaderProgram.ID, "view");
         cam.SetProjectionMatrixUniform(shaderProgram.ID, "projection", proj);
         
-        std::vector<GLint>   firsts;
-        std::vector<GLsizei> counts;
-        size_t N = handler.retrieveFirstsAndCounts(firsts, counts);
+        // A few meshes per frame move down the quad heap so its free space stays in one piece
+        handler.compactQuadHeap(4);
+
+        // This frame's share of finished meshes goes to the GPU in one batch
+        handler.flushUploads();
+
+        // Kept up to date by the handler, no per-frame rebuild
+        const ChunkDrawTable& draws = handler.getDrawTable();
+        const GLsizei N = static_cast<GLsizei>(draws.size());
         
         handler.bindQuadsSSBO(1);
         handler.bindMetadataSSBO(2);
@@ -438,10 +445,10 @@ int main() {
         if (render_check == true) {
             if (render_trig == true) {
                 //glDrawArrays(GL_TRIANGLES, 0, (meshData.vertexCount - 1) * 6);
-                glMultiDrawArrays(GL_TRIANGLES, firsts.data(), counts.data(), static_cast<GLsizei>(N));
+                glMultiDrawArrays(GL_TRIANGLES, draws.firsts(), draws.counts(), N);
             }
             else {
-                glMultiDrawArrays(GL_LINES, firsts.data(), counts.data(), static_cast<GLsizei>(N));
+                glMultiDrawArrays(GL_LINES, draws.firsts(), draws.counts(), N);
             }
             
         }
@@ -460,6 +467,14 @@ int main() {
         ImGui::SliderInt("Edit Type", &edit_type, 0, 7);
         ImGui::SliderInt("Edit Shape", &edit_shape, 0, 1);
         ImGui::ColorEdit4("BackGround Color", color);
+        ImGui::Text("Metadata upload: %zu bytes/frame", handler.getMetadataBytesUploaded());
+        ImGui::Text("Quad upload: %zu bytes/frame, %zu queued", handler.getUploadedBytes(), handler.getPendingUploadBytes());
+        const PoolStats heap = handler.getQuadHeapStats();
+        ImGui::Text("Quad heap: %u free, largest block %u (%.0f%% fragmented)",
+            heap.freeSize, heap.largestFreeBlock, heap.fragmentation() * 100.0f);
+        HeightmapCache& heightmaps = handler.getHeightmapCache();
+        ImGui::Text("Heightmap tiles: %zu cached, %llu hits, %llu misses", heightmaps.size(),
+            static_cast<unsigned long long>(heightmaps.getHits()), static_cast<unsigned long long>(heightmaps.getMisses()));
         ImGui::End();
 
         
@@ -467,8 +482,8 @@ int main() {
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-        // Ensure rendering commands are finished
-        glFinish();
+        // Fences this frame's draws so the quad ranges they read are not reused too early
+        handler.endFrame();
 
         
 
@@ -5,6 +5,9 @@
 #include <vector> // Replaced VectorF with std::vector
 #include <numeric> // For std::iota (used in IDPool replacement)
 #include <algorithm> // For std::remove_if (used in IDPool replacement)
+#ifdef _MSC_VER
+#include <intrin.h> // _BitScanForward / _BitScanReverse
+#endif
 
 // Simple IDPool replacement using std::vector
 class IDPool {
@@ -40,6 +43,28 @@ struct MemoryBlock {
 	uint32_t size;
 };
 
+// Free-space picture of a pool; fragmentation() is 0 when all free space is one block
+struct PoolStats {
+	uint32_t capacity;
+	uint32_t usedSize;
+	uint32_t freeSize;
+	uint32_t largestFreeBlock;
+	uint32_t freeBlockCount;
+
+	float fragmentation() const {
+		return freeSize ? 1.0f - static_cast<float>(largestFreeBlock) / freeSize : 0.0f;
+	}
+};
+
+// Free blocks are indexed TLSF-style: a first level by power of two and SL_COUNT
+// linear second-level bins per power, with a bitmap per level. allocate() takes
+// the head of the smallest non-empty bin whose blocks all fit (falling back to a
+// scan of the request's own bin), so allocation and deallocation are O(1).
+// Freed blocks still merge with free left/right neighbors immediately.
+//
+// With ownsMemory = false the pool is a pure offset allocator: it only hands out
+// positions (e.g. into a GPU buffer) and getAddress() must not be used.
+// ownsMemory = true also keeps a T[capacity] array the positions index into.
 template <typename T, bool AllocateNodes = true>
 class UniversalPool {
 public:
@@ -58,16 +83,26 @@ public:
 		usedNodeAllocator.reset();
 		usedNodes.clear(); // Clear usedNodes when resetting
 		freeNodes.clear();
+		flBitmap = 0;
+		for (int fl = 0; fl < FL_COUNT; fl++) {
+			slBitmap[fl] = 0;
+			for (int sl = 0; sl < SL_COUNT; sl++) binHead[fl][sl] = -1;
+		}
+		usedSize = 0;
 
 		freeNodes.push_back(MemoryNode{ 0, capacity, -1, -1 });
+		linkFreeNode(0);
 	}
 
 	void setEndPadding(uint32_t size) {
+		unlinkFreeNode(0);
 		freeNodes[0].size -= size;
+		linkFreeNode(0);
 	}
 
 	void deallocate(int nodeID) {
 		MemoryNode& node = usedNodes[nodeID]; // This assumes nodeID is always valid for usedNodes' current size
+		usedSize -= node.size;
 
 		int leftNodeID = node.leftID & (~IS_FREE_NODE);
 		MemoryNode* leftFreeNode = node.leftID >= IS_FREE_NODE ? &freeNodes[leftNodeID] : nullptr;
@@ -76,73 +111,113 @@ public:
 		MemoryNode* rightFreeNode = node.rightID >= IS_FREE_NODE ? &freeNodes[rightNodeID] : nullptr;
 
 		if (leftFreeNode != nullptr) {
+			unlinkFreeNode(leftNodeID);
 			leftFreeNode->size += node.size;
 
 			if (rightFreeNode == nullptr) {
 				leftFreeNode->rightID = node.rightID;
 				if (node.rightID != -1) usedNodes[node.rightID].leftID = node.leftID;
+				linkFreeNode(leftNodeID);
 			}
 			else {
+				unlinkFreeNode(rightNodeID);
 				leftFreeNode->size += rightFreeNode->size;
 
 				leftFreeNode->rightID = rightFreeNode->rightID;
 				if (rightFreeNode->rightID != -1) usedNodes[rightFreeNode->rightID].leftID = node.leftID;
 
+				linkFreeNode(leftNodeID);
 				removeFreeNode(rightNodeID);
 			}
 		}
 
 		if (rightFreeNode != nullptr && leftFreeNode == nullptr) {
+			unlinkFreeNode(rightNodeID);
 			rightFreeNode->position = node.position;
 			rightFreeNode->size += node.size;
 
 			rightFreeNode->leftID = node.leftID;
 			if (node.leftID != -1) usedNodes[node.leftID].rightID = node.rightID;
+			linkFreeNode(rightNodeID);
 		}
 
 		if (leftFreeNode == nullptr && rightFreeNode == nullptr) {
 			int freeNodeID = static_cast<int>(freeNodes.size()) | IS_FREE_NODE;
 			freeNodes.push_back(node);
+			linkFreeNode(static_cast<int>(freeNodes.size()) - 1);
 
 			if (node.leftID != -1) usedNodes[node.leftID].rightID = freeNodeID;
 			if (node.rightID != -1) usedNodes[node.rightID].leftID = freeNodeID;
 		}
 
+		usedNodes[nodeID].rightID = DEAD_NODE; // keeps grow() from mistaking it for the last block
 		if constexpr (AllocateNodes) usedNodeAllocator.deallocate(nodeID);
 	}
 
-	bool allocate(int& nodeID, uint32_t size) {
-		if (!seekFreeNode(size)) return false;
-		MemoryNode& freeNode = freeNodes[searchID];
+	// Extend the pool to newCapacity slots. The new space joins the free block at
+	// the end, or becomes one after the last used block. O(nodes); meant to be rare.
+	void grow(uint32_t newCapacity) {
+		if (newCapacity <= capacity) return;
+		const uint32_t added = newCapacity - capacity;
+
+		if (memory) {
+			T* grown = new T[newCapacity];
+			std::copy(memory, memory + capacity, grown);
+			delete[] memory;
+			memory = grown;
+		}
 
-		if constexpr (AllocateNodes) {
-			nodeID = usedNodeAllocator.allocate();
-			// Crucial fix: Ensure usedNodes is large enough to hold nodeID
-			if (static_cast<size_t>(nodeID) >= usedNodes.size()) {
-				usedNodes.resize(nodeID + 1); // Resize to accommodate the new nodeID
-			}
+		// The last block is the only node without a right neighbor
+		for (int id = 0; id < static_cast<int>(freeNodes.size()); id++) {
+			if (freeNodes[id].rightID != -1) continue;
+			unlinkFreeNode(id);
+			freeNodes[id].size += added;
+			linkFreeNode(id);
+			capacity = newCapacity;
+			return;
 		}
-		MemoryNode& node = usedNodes.at(nodeID); // .at() will now work correctly after resize
-		node.position = freeNode.position;
-		node.size = size;
+		for (int id = 0; id < static_cast<int>(usedNodes.size()); id++) {
+			if (usedNodes[id].rightID != -1) continue;
+			const int freeID = static_cast<int>(freeNodes.size());
+			freeNodes.push_back(MemoryNode{ capacity, added, id, -1 });
+			linkFreeNode(freeID);
+			usedNodes[id].rightID = freeID | IS_FREE_NODE;
+			break;
+		}
+		capacity = newCapacity;
+	}
 
-		node.leftID = freeNode.leftID;
-		if (node.leftID != -1) usedNodes[node.leftID].rightID = nodeID;
+	uint32_t getCapacity() const { return capacity; }
 
-		freeNode.size -= size;
-		if (freeNode.size == 0) {
-			node.rightID = freeNode.rightID;
-			if (node.rightID != -1) usedNodes[node.rightID].leftID = nodeID;
+	bool allocate(int& nodeID, uint32_t size) {
+		const int searchID = findFreeNode(size);
+		if (searchID < 0) return false;
+		allocateFrom(searchID, nodeID, size);
+		return true;
+	}
 
-			removeFreeNode(searchID);
+	// Allocate at the lowest address where size fits entirely below 'below'.
+	// O(free blocks); meant for compaction, which moves blocks down one at a time.
+	bool allocateLowest(int& nodeID, uint32_t size, uint32_t below) {
+		int searchID = -1;
+		for (int id = 0; id < static_cast<int>(freeNodes.size()); id++) {
+			const MemoryNode& node = freeNodes[id];
+			if (node.size < size || uint64_t(node.position) + size > below) continue;
+			if (searchID < 0 || node.position < freeNodes[searchID].position) searchID = id;
 		}
-		else {
-			freeNode.position += size;
+		if (searchID < 0) return false;
+		allocateFrom(searchID, nodeID, size);
+		return true;
+	}
 
-			freeNode.leftID = nodeID;
-			node.rightID = searchID | IS_FREE_NODE;
+	// Lowest-addressed free block; false if the pool is full. O(free blocks).
+	bool getLowestFreeBlock(MemoryBlock& block) const {
+		if (freeNodes.empty()) return false;
+		const MemoryNode* lowest = &freeNodes[0];
+		for (const MemoryNode& node : freeNodes) {
+			if (node.position < lowest->position) lowest = &node;
 		}
-
+		block = MemoryBlock{ lowest->position, lowest->size };
 		return true;
 	}
 
@@ -154,35 +229,179 @@ public:
 	T* getAddress(uint32_t position) {
 		return memory + position;
 	}
+	const T* getAddress(uint32_t position) const {
+		return memory + position;
+	}
+	bool ownsMemory() const { return memory != nullptr; }
+
+	// O(free blocks); the largest block comes from the highest non-empty bin
+	PoolStats getStats() const {
+		PoolStats stats{};
+		stats.capacity = capacity;
+		stats.usedSize = usedSize;
+		stats.freeBlockCount = static_cast<uint32_t>(freeNodes.size());
+		for (const MemoryNode& node : freeNodes) stats.freeSize += node.size;
+		if (flBitmap) {
+			const int fl = highestBit(flBitmap);
+			const int sl = highestBit(slBitmap[fl]);
+			for (int id = binHead[fl][sl]; id != -1; id = freeNodes[id].nextFree) {
+				if (freeNodes[id].size > stats.largestFreeBlock) stats.largestFreeBlock = freeNodes[id].size;
+			}
+		}
+		return stats;
+	}
 protected:
 	T* memory = nullptr;
 	uint32_t capacity;
+	uint32_t usedSize = 0;
 
 	struct MemoryNode {
 		uint32_t position, size;
 		int leftID, rightID;
+		int prevFree = -1, nextFree = -1; // bin list links, free nodes only
 	};
 
 	static constexpr int IS_FREE_NODE = 1 << 30;
+	static constexpr int DEAD_NODE = -2; // rightID of a deallocated used node
 	std::vector<MemoryNode> freeNodes, usedNodes;
 	IDPool usedNodeAllocator;
 
-	int searchID = 0;
-	bool seekFreeNode(uint32_t size) {
-		for (int i = 0; i < 2; i++) {
-			for (; searchID < static_cast<int>(freeNodes.size()); searchID++) {
-				if (freeNodes[searchID].size >= size) return true;
+	// TLSF index. Sizes below SL_COUNT get exact bins in first level 0,
+	// larger sizes s go to fl = log2(s) - SL_BITS + 1.
+	static constexpr int SL_BITS = 4;
+	static constexpr int SL_COUNT = 1 << SL_BITS;
+	static constexpr int FL_COUNT = 32 - SL_BITS + 1;
+	uint32_t flBitmap = 0;
+	uint32_t slBitmap[FL_COUNT];
+	int binHead[FL_COUNT][SL_COUNT];
+
+	static int highestBit(uint32_t v) {
+		unsigned long bit;
+#ifdef _MSC_VER
+		_BitScanReverse(&bit, v);
+#else
+		bit = 31 - __builtin_clz(v);
+#endif
+		return static_cast<int>(bit);
+	}
+	static int lowestBit(uint32_t v) {
+		unsigned long bit;
+#ifdef _MSC_VER
+		_BitScanForward(&bit, v);
+#else
+		bit = __builtin_ctz(v);
+#endif
+		return static_cast<int>(bit);
+	}
+
+	static void mapSize(uint32_t size, int& fl, int& sl) {
+		if (size < static_cast<uint32_t>(SL_COUNT)) {
+			fl = 0;
+			sl = static_cast<int>(size);
+			return;
+		}
+		const int log2 = highestBit(size);
+		fl = log2 - SL_BITS + 1;
+		sl = static_cast<int>((size >> (log2 - SL_BITS)) ^ SL_COUNT);
+	}
+
+	void linkFreeNode(int id) {
+		MemoryNode& node = freeNodes[id];
+		int fl, sl;
+		mapSize(node.size, fl, sl);
+		node.prevFree = -1;
+		node.nextFree = binHead[fl][sl];
+		if (node.nextFree != -1) freeNodes[node.nextFree].prevFree = id;
+		binHead[fl][sl] = id;
+		flBitmap |= 1u << fl;
+		slBitmap[fl] |= 1u << sl;
+	}
+
+	void unlinkFreeNode(int id) {
+		MemoryNode& node = freeNodes[id];
+		int fl, sl;
+		mapSize(node.size, fl, sl);
+		if (node.prevFree != -1) freeNodes[node.prevFree].nextFree = node.nextFree;
+		else binHead[fl][sl] = node.nextFree;
+		if (node.nextFree != -1) freeNodes[node.nextFree].prevFree = node.prevFree;
+		if (binHead[fl][sl] == -1) {
+			slBitmap[fl] &= ~(1u << sl);
+			if (!slBitmap[fl]) flBitmap &= ~(1u << fl);
+		}
+	}
+
+	// A free node with size >= size, or -1
+	int findFreeNode(uint32_t size) const {
+		// Round up to the next bin so every block in the found bin fits
+		uint64_t rounded = size;
+		if (size >= static_cast<uint32_t>(SL_COUNT)) rounded += (1ull << (highestBit(size) - SL_BITS)) - 1;
+		if (rounded <= UINT32_MAX) {
+			int fl, sl;
+			mapSize(static_cast<uint32_t>(rounded), fl, sl);
+			uint32_t slMap = slBitmap[fl] & (~0u << sl);
+			if (!slMap) {
+				const uint32_t flMap = fl + 1 < 32 ? flBitmap & (~0u << (fl + 1)) : 0;
+				if (flMap) {
+					fl = lowestBit(flMap);
+					slMap = slBitmap[fl];
+				}
+			}
+			if (slMap) return binHead[fl][lowestBit(slMap)];
+		}
+
+		// Only the request's own bin may still hold a block that fits
+		int fl, sl;
+		mapSize(size, fl, sl);
+		for (int id = binHead[fl][sl]; id != -1; id = freeNodes[id].nextFree) {
+			if (freeNodes[id].size >= size) return id;
+		}
+		return -1;
+	}
+
+	// Carve size slots off the front of free node searchID
+	void allocateFrom(int searchID, int& nodeID, uint32_t size) {
+		unlinkFreeNode(searchID);
+		MemoryNode& freeNode = freeNodes[searchID];
+
+		if constexpr (AllocateNodes) {
+			nodeID = usedNodeAllocator.allocate();
+			// Crucial fix: Ensure usedNodes is large enough to hold nodeID
+			if (static_cast<size_t>(nodeID) >= usedNodes.size()) {
+				usedNodes.resize(nodeID + 1); // Resize to accommodate the new nodeID
 			}
-			searchID = 0;
 		}
+		MemoryNode& node = usedNodes.at(nodeID); // .at() will now work correctly after resize
+		node.position = freeNode.position;
+		node.size = size;
+		usedSize += size;
 
-		return false;
+		node.leftID = freeNode.leftID;
+		if (node.leftID != -1) usedNodes[node.leftID].rightID = nodeID;
+
+		freeNode.size -= size;
+		if (freeNode.size == 0) {
+			node.rightID = freeNode.rightID;
+			if (node.rightID != -1) usedNodes[node.rightID].leftID = nodeID;
+
+			removeFreeNode(searchID);
+		}
+		else {
+			freeNode.position += size;
+
+			freeNode.leftID = nodeID;
+			node.rightID = searchID | IS_FREE_NODE;
+			linkFreeNode(searchID);
+		}
 	}
 
+	// Drops an unlinked free node; the last free node takes its ID
 	void removeFreeNode(int nodeID) {
+		const int lastID = static_cast<int>(freeNodes.size()) - 1;
+		if (nodeID != lastID) unlinkFreeNode(lastID);
 		freeNodes[nodeID] = freeNodes.back();
 		freeNodes.pop_back();
 		if (nodeID == static_cast<int>(freeNodes.size())) return;
+		linkFreeNode(nodeID);
 
 		MemoryNode& node = freeNodes[nodeID];
 		if (node.leftID != -1) usedNodes[node.leftID].rightID = nodeID | IS_FREE_NODE;
@@ -190,4 +409,4 @@ protected:
 	}
 };
 
-#endif
\ No newline at end of file
+#endif
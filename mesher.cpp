@@ -6,6 +6,21 @@
 #include <string.h> // memset
 #endif
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BM_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang only emit AVX2 for functions marked with it; MSVC emits any intrinsic
+#if defined(BM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BM_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BM_TARGET(isa)
+#endif
+
 static inline const int getAxisIndex(const int axis, const int a, const int b, const int c) {
     if (axis == 0) return b + (a * CS_P) + (c * CS_P2);
     else if (axis == 1) return b + (c * CS_P) + (a * CS_P2);
@@ -49,6 +64,10 @@ static inline const uint64_t getQuad(uint64_t x, uint64_t y, uint64_t z, uint64_
 constexpr uint64_t P_MASK = ~(1ull << 63 | 1);
 
 void mesh(const uint8_t* voxels, MeshData& meshData) {
+    mesh(voxels, meshData, nullptr);
+}
+
+void mesh(const uint8_t* voxels, MeshData& meshData, const uint64_t dirtyLayers[6]) {
     meshData.vertexCount = 0;
     int vertexI = 0;
 
@@ -82,8 +101,10 @@ void mesh(const uint8_t* voxels, MeshData& meshData) {
         const int axis = face / 2;
 
         const int faceVertexBegin = vertexI;
+        const uint64_t layerMask = dirtyLayers ? dirtyLayers[face] : ~0ull;
 
         for (int layer = 0; layer < CS; layer++) {
+            if (!(layerMask >> layer & 1)) continue;
             const int bitsLocation = layer * CS + face * CS_2;
 
             for (int forward = 0; forward < CS; forward++) {
@@ -161,13 +182,15 @@ void mesh(const uint8_t* voxels, MeshData& meshData) {
         const int axis = face / 2;
 
         const int faceVertexBegin = vertexI;
+        // Layers are the column bits here (bit 0 is padding), merges never cross them
+        const uint64_t layerBits = dirtyLayers ? dirtyLayers[face] << 1 : ~0ull;
 
         for (int forward = 0; forward < CS; forward++) {
             const int bitsLocation = forward * CS + face * CS_2;
             const int bitsForwardLocation = (forward + 1) * CS + face * CS_2;
 
             for (int right = 0; right < CS; right++) {
-                uint64_t bitsHere = faceMasks[right + bitsLocation];
+                uint64_t bitsHere = faceMasks[right + bitsLocation] & layerBits;
                 if (bitsHere == 0) continue;
 
                 const uint64_t bitsForward = forward < CS - 1 ? faceMasks[right + bitsForwardLocation] : 0;
@@ -221,5 +244,115 @@ void mesh(const uint8_t* voxels, MeshData& meshData) {
         meshData.faceVertexLength[face] = faceVertexLength;
     }
 
-    meshData.vertexCount = vertexI + 1;
+    meshData.vertexCount = vertexI;
+}
+
+static void buildOpaqueMaskScalar(const uint8_t* voxels, uint64_t* opaqueMask) {
+    for (int row = 0; row < CS_P2; row++) {
+        const uint8_t* rowVoxels = voxels + row * CS_P;
+        uint64_t bits = 0;
+        for (int i = 0; i < CS_P; i++) {
+            if (rowVoxels[i]) bits |= (1ull << i);
+        }
+        opaqueMask[row] = bits;
+    }
+}
+
+#ifdef BM_X86
+// One 64-voxel row = 4 x 16 bytes. movemask of (voxel == 0) gives the air bits, inverted below.
+BM_TARGET("sse2")
+static void buildOpaqueMaskSSE2(const uint8_t* voxels, uint64_t* opaqueMask) {
+    const __m128i zero = _mm_setzero_si128();
+    for (int row = 0; row < CS_P2; row++) {
+        const __m128i* rowVoxels = reinterpret_cast<const __m128i*>(voxels + row * CS_P);
+        const uint64_t m0 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(rowVoxels + 0), zero)));
+        const uint64_t m1 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(rowVoxels + 1), zero)));
+        const uint64_t m2 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(rowVoxels + 2), zero)));
+        const uint64_t m3 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(rowVoxels + 3), zero)));
+        opaqueMask[row] = ~(m0 | (m1 << 16) | (m2 << 32) | (m3 << 48));
+    }
+}
+
+// Same with 2 x 32 bytes per row
+BM_TARGET("avx2")
+static void buildOpaqueMaskAVX2(const uint8_t* voxels, uint64_t* opaqueMask) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (int row = 0; row < CS_P2; row++) {
+        const __m256i* rowVoxels = reinterpret_cast<const __m256i*>(voxels + row * CS_P);
+        const uint64_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(rowVoxels + 0), zero)));
+        const uint64_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(rowVoxels + 1), zero)));
+        opaqueMask[row] = ~(lo | (hi << 32));
+    }
+}
+
+static bool cpuHasSSE2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true; // part of x86-64
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] >> 26) & 1;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] >> 27) & 1;
+    const bool avx = (info[2] >> 28) & 1;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves the YMM registers
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // BM_X86
+
+static bool opaqueMaskPathSupported(OpaqueMaskPath path) {
+    switch (path) {
+    case OPAQUE_MASK_SCALAR: return true;
+#ifdef BM_X86
+    case OPAQUE_MASK_SSE2: return cpuHasSSE2();
+    case OPAQUE_MASK_AVX2: return cpuHasAVX2();
+#endif
+    default: return false;
+    }
+}
+
+OpaqueMaskPath getOpaqueMaskPath() {
+    static const OpaqueMaskPath selected =
+        opaqueMaskPathSupported(OPAQUE_MASK_AVX2) ? OPAQUE_MASK_AVX2 :
+        opaqueMaskPathSupported(OPAQUE_MASK_SSE2) ? OPAQUE_MASK_SSE2 :
+        OPAQUE_MASK_SCALAR;
+    return selected;
+}
+
+typedef void (*OpaqueMaskFn)(const uint8_t*, uint64_t*);
+
+static OpaqueMaskFn opaqueMaskFn(OpaqueMaskPath path) {
+    switch (path) {
+#ifdef BM_X86
+    case OPAQUE_MASK_SSE2: return buildOpaqueMaskSSE2;
+    case OPAQUE_MASK_AVX2: return buildOpaqueMaskAVX2;
+#endif
+    default: return buildOpaqueMaskScalar;
+    }
+}
+
+bool buildOpaqueMaskWithPath(OpaqueMaskPath path, const uint8_t* voxels, uint64_t* opaqueMask) {
+    if (!opaqueMaskPathSupported(path)) return false;
+    opaqueMaskFn(path)(voxels, opaqueMask);
+    return true;
+}
+
+void buildOpaqueMask(const uint8_t* voxels, uint64_t* opaqueMask) {
+    static const OpaqueMaskFn fn = opaqueMaskFn(getOpaqueMaskPath()); // CPU check runs once
+    fn(voxels, opaqueMask);
 }
\ No newline at end of file
@@ -37,4 +37,32 @@ struct MeshData {
 // @param[out] meshData The allocated vertices in MeshData with a length of meshData.vertexCount.
 void mesh(const uint8_t* voxels, MeshData& meshData);
 
+// Same as mesh(), but the greedy pass only visits the layers set in dirtyLayers[face]
+// (bit l = interior layer l along the face normal: y for faces 0-1, x for 2-3, z for 4-5).
+// Only quads of those layers are emitted; the hidden face culling still covers the chunk.
+void mesh(const uint8_t* voxels, MeshData& meshData, const uint64_t dirtyLayers[6]);
+
+// Builds the CS_P2 column bitmasks that mesh() reads from meshData.opaqueMask.
+// Bit i of opaqueMask[row] is set when voxels[row * CS_P + i] is non-zero (ZXY order, 64^3 input).
+//
+// @param[in] voxels: Same padded 64^3 input that is passed to mesh().
+// @param[out] opaqueMask: CS_P2 entries, fully overwritten.
+//
+// Uses AVX2 or SSE2 compare + movemask when the CPU has it (picked once at runtime),
+// otherwise a scalar loop.
+void buildOpaqueMask(const uint8_t* voxels, uint64_t* opaqueMask);
+
+enum OpaqueMaskPath {
+    OPAQUE_MASK_SCALAR,
+    OPAQUE_MASK_SSE2,
+    OPAQUE_MASK_AVX2,
+};
+
+// The path buildOpaqueMask() dispatches to on this machine
+OpaqueMaskPath getOpaqueMaskPath();
+
+// buildOpaqueMask() forced onto one path, for benchmarks and cross-checking.
+// Returns false (and writes nothing) if this build or CPU can't run that path.
+bool buildOpaqueMaskWithPath(OpaqueMaskPath path, const uint8_t* voxels, uint64_t* opaqueMask);
+
 #endif // MESHER_H
\ No newline at end of file